@@ -0,0 +1,100 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <glm/glm.hpp>
+#include "../CubularEngine/SimdOverlap.h"
+
+//Compares the batched overlap kernel at every instruction set the CPU has against
+//the scalar position +- collider test the collision response uses for each pair, and exits 1 if any of them disagree
+
+//the scalar test from PhysicsWorld::ResolveCollision, one pair at a time
+static bool ScalarCollision(glm::vec3 positionA, glm::vec3 colliderA, glm::vec3 positionB, glm::vec3 colliderB)
+{
+	return (positionA.x + colliderA.x <= (positionB.x + colliderB.x) && positionA.x + colliderA.x >= (positionB.x - colliderB.x) ||
+		positionA.x - colliderA.x <= (positionB.x + colliderB.x) && positionA.x - colliderA.x >= (positionB.x - colliderB.x))
+		&&
+		(positionA.y + colliderA.y <= (positionB.y + colliderB.y) && positionA.y + colliderA.y >= (positionB.y - colliderB.y) ||
+			positionA.y - colliderA.y <= (positionB.y + colliderB.y) && positionA.y - colliderA.y >= (positionB.y - colliderB.y))
+		&&
+		(positionA.z + colliderA.z <= (positionB.z + colliderB.z) && positionA.z + colliderA.z >= (positionB.z - colliderB.z) ||
+			positionA.z - colliderA.z <= (positionB.z + colliderB.z) && positionA.z - colliderA.z >= (positionB.z - colliderB.z));
+}
+
+static float RandomRange(float min, float max)
+{
+	return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+int main()
+{
+	const int boxCount = 4096;
+	const int queryCount = 1024;
+	const float arenaSize = 40.f;
+
+	//same sized cubes as the arena, where the scalar test and the kernel agree exactly
+	glm::vec3 collider(0.5f, 0.5f, 0.5f);
+	srand(1234);
+
+	std::vector<glm::vec3> positions(boxCount);
+	AABBBatch batch;
+	for (int i = 0; i < boxCount; i++)
+	{
+		positions[i] = glm::vec3(RandomRange(0.f, arenaSize), RandomRange(0.f, arenaSize), RandomRange(0.f, arenaSize));
+		batch.Add(AABB::FromCenter(positions[i], collider));
+	}
+
+	std::vector<glm::vec3> queries(queryCount);
+	for (int i = 0; i < queryCount; i++)
+	{
+		queries[i] = glm::vec3(RandomRange(0.f, arenaSize), RandomRange(0.f, arenaSize), RandomRange(0.f, arenaSize));
+	}
+
+	std::vector<unsigned int> hits(boxCount);
+	double tests = (double)boxCount * queryCount;
+
+	std::cout << "Overlap kernel benchmark: " << queryCount << " boxes against " << boxCount << std::endl;
+	std::cout << "Best supported: " << GetSimdLevelName(GetSupportedSimdLevel()) << std::endl;
+
+	//scalar pair by pair
+	long long scalarHits = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int q = 0; q < queryCount; q++)
+	{
+		for (int i = 0; i < boxCount; i++)
+		{
+			scalarHits += ScalarCollision(queries[q], collider, positions[i], collider);
+		}
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	double scalarTime = std::chrono::duration<double, std::nano>(end - start).count();
+	std::cout << "Pair by pair:  " << scalarTime / tests << " ns per test, " << scalarHits << " hits" << std::endl;
+
+	SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 };
+	bool mismatch = false;     //any level disagreeing with the pair by pair test fails the run
+	for (int l = 0; l < 4; l++)
+	{
+		if (levels[l] > GetSupportedSimdLevel())
+		{
+			std::cout << GetSimdLevelName(levels[l]) << ": not supported" << std::endl;
+			continue;
+		}
+		SetSimdLevel(levels[l]);
+
+		long long batchHits = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (int q = 0; q < queryCount; q++)
+		{
+			batchHits += FindOverlaps(AABB::FromCenter(queries[q], collider), batch, 0, boxCount, hits.data());
+		}
+		end = std::chrono::high_resolution_clock::now();
+		double time = std::chrono::duration<double, std::nano>(end - start).count();
+
+		std::cout << GetSimdLevelName(levels[l]) << ": " << time / tests << " ns per test, " << batchHits << " hits, "
+			<< scalarTime / time << "x faster" << (batchHits != scalarHits ? " (HITS DON'T MATCH)" : "") << std::endl;
+		mismatch |= batchHits != scalarHits;
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	return mismatch ? 1 : 0;
+}
@@ -0,0 +1,367 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include "../CubularEngine/PhysicsWorld.h"
+#include "../CubularEngine/Octree.h"
+#include "../CubularEngine/SweepAndPrune.h"
+#include "../CubularEngine/TreeBroadphase.h"
+#include "../CubularEngine/SpatialHashGrid.h"
+#include "../CubularEngine/BruteForceBroadphase.h"
+#include "../CubularEngine/SimulationLod.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+//Steps the linear momentum example's walled arena with more and more cubes, timing every part of the step,
+//and writes the percentiles out as JSON. Shows where each broadphase stops fitting in a frame, and catches regressions.
+//A count fits the budget when its p95 step time is under it, and the largest count in budget is the biggest one
+//where every smaller count fit too (so one slow outlier can't make a big count look better than a small one).
+//--lod steps the cubes through a SimulationLod, as seen by a camera above one corner of the arena looking at the middle
+static const char* Usage =
+	"usage: CubularPhysicsBenchmark [--counts 1000,10000,100000,1000000] [--broadphases sap,tree,hash,octree,brute]\n"
+	"                               [--steps 60] [--warmup 10] [--threads 0] [--seed 1234] [--area-per-cube 4]\n"
+	"                               [--budget 16.67] [--max-step-ms 1000] [--lod near,far] [--out results.json]\n";
+
+struct Options
+{
+	std::vector<int> counts = { 1000, 10000, 100000, 1000000 };
+	std::vector<std::string> broadphases = { "sap", "tree", "hash", "octree", "brute" };
+	int steps = 60;
+	int warmup = 10;
+	int threads = 0;
+	unsigned int seed = 1234;
+	float areaPerCube = 4.f;    //floor space per cube, the example itself is much sparser (about 45)
+	double budget = 1000.0 / 60.0;
+	double maxStepMilliseconds = 1000.0;    //bigger counts are skipped once a step is slower than this
+	float lodNear = 0.f;                    //0 steps everything every step
+	float lodFar = 0.f;
+	std::string output;
+};
+
+//the parts of the step that get timed, in the order they're written out
+static const int PhaseCount = 6;
+static const char* PhaseNames[PhaseCount] = { "broadphase", "islands", "narrowphase", "response", "integration", "total" };
+
+struct PhaseStats
+{
+	double mean;
+	double p50;
+	double p90;
+	double p95;
+	double p99;
+	double max;
+};
+
+static std::vector<std::string> Split(const std::string& list)
+{
+	std::vector<std::string> parts;
+	std::stringstream stream(list);
+	std::string part;
+	while (std::getline(stream, part, ','))
+	{
+		if (!part.empty())
+		{
+			parts.push_back(part);
+		}
+	}
+	return parts;
+}
+
+//every option takes a value
+static const char* OptionNames[] = { "--counts", "--broadphases", "--steps", "--warmup", "--threads", "--seed",
+	"--area-per-cube", "--budget", "--max-step-ms", "--out", "--lod" };
+
+static bool ParseOptions(int argc, char** argv, Options& options)
+{
+	for (int i = 1; i < argc; i += 2)
+	{
+		std::string name = argv[i];
+		if (std::find(std::begin(OptionNames), std::end(OptionNames), name) == std::end(OptionNames))
+		{
+			std::cerr << "Unknown option " << name << std::endl;
+			return false;
+		}
+		if (i + 1 >= argc)
+		{
+			std::cerr << name << " needs a value" << std::endl;
+			return false;
+		}
+
+		const char* value = argv[i + 1];
+		if (name == "--counts")
+		{
+			options.counts.clear();
+			std::vector<std::string> counts = Split(value);
+			for (int c = 0; c < counts.size(); c++)
+			{
+				options.counts.push_back(atoi(counts[c].c_str()));
+			}
+
+			//smallest first, the largest count in budget relies on it
+			std::sort(options.counts.begin(), options.counts.end());
+		}
+		else if (name == "--broadphases") options.broadphases = Split(value);
+		else if (name == "--steps") options.steps = std::max(1, atoi(value));
+		else if (name == "--warmup") options.warmup = std::max(0, atoi(value));
+		else if (name == "--threads") options.threads = atoi(value);
+		else if (name == "--seed") options.seed = (unsigned int)strtoul(value, nullptr, 10);
+		else if (name == "--area-per-cube") options.areaPerCube = (float)atof(value);
+		else if (name == "--budget") options.budget = atof(value);
+		else if (name == "--max-step-ms") options.maxStepMilliseconds = atof(value);
+		else if (name == "--out") options.output = value;
+		else if (name == "--lod")
+		{
+			std::vector<std::string> distances = Split(value);
+			options.lodNear = distances.size() > 0 ? (float)atof(distances[0].c_str()) : 0.f;
+			options.lodFar = distances.size() > 1 ? (float)atof(distances[1].c_str()) : options.lodNear * 2.5f;
+		}
+	}
+	return true;
+}
+
+//nearest rank percentile of already sorted samples
+static double Percentile(const std::vector<double>& sorted, double percent)
+{
+	int rank = (int)std::ceil(percent / 100.0 * sorted.size());
+	return sorted[std::min(std::max(rank, 1), (int)sorted.size()) - 1];
+}
+
+static PhaseStats GetStats(std::vector<double> samples)
+{
+	std::sort(samples.begin(), samples.end());
+
+	PhaseStats stats;
+	double sum = 0.0;
+	for (int i = 0; i < samples.size(); i++)
+	{
+		sum += samples[i];
+	}
+	stats.mean = sum / samples.size();
+	stats.p50 = Percentile(samples, 50.0);
+	stats.p90 = Percentile(samples, 90.0);
+	stats.p95 = Percentile(samples, 95.0);
+	stats.p99 = Percentile(samples, 99.0);
+	stats.max = samples.back();
+	return stats;
+}
+
+static Broadphase* CreateBroadphase(const std::string& name, float halfSize, ThreadPool* threadPool)
+{
+	if (name == "octree")
+	{
+		//deep enough that the leaves end up around the size of a cube
+		int depth = std::min(10, std::max(1, (int)std::ceil(std::log2(halfSize))));
+		return new Octree(glm::vec3(0.f, -7.f, 0.f), halfSize + 4.f, depth, 8);
+	}
+	if (name == "tree")
+	{
+		return new TreeBroadphase(0.1f);
+	}
+	if (name == "hash")
+	{
+		//cells twice the size of the cubes
+		return new SpatialHashGrid(threadPool, 2.f);
+	}
+	if (name == "brute")
+	{
+		return new BruteForceBroadphase();
+	}
+	if (name == "sap")
+	{
+		return new SweepAndPrune();
+	}
+	return nullptr;
+}
+
+//half the width of an arena with room for cubeCount cubes
+static float GetArenaHalfSize(int cubeCount, const Options& options)
+{
+	return std::max(20.f, std::sqrt(cubeCount * options.areaPerCube) * 0.5f);
+}
+
+//the linear momentum example (floor, four walls and cubes pushed in random directions), grown to fit cubeCount cubes
+static void CreateArena(PhysicsWorld* world, int cubeCount, float halfSize, const Options& options)
+{
+	std::mt19937 random(options.seed);
+	std::uniform_real_distribution<float> spawn(-halfSize + 3.f, halfSize - 3.f);
+	std::uniform_real_distribution<float> force(-0.5f, 0.5f);
+
+	TagRegistry* tags = TagRegistry::GetInstance();
+	unsigned int floor = world->CreateBody(glm::vec3(0.f, -10.f, 0.f), glm::vec3(halfSize + 4.f, 1.f, halfSize + 4.f), 1, false, tags->Intern("Floor"));
+	world->SetCollisionLayer(floor, LayerScenery);
+
+	glm::vec3 wallPositions[4] = { glm::vec3(0.f, -7.f, halfSize), glm::vec3(0.f, -7.f, -halfSize), glm::vec3(halfSize, -7.f, 0.f), glm::vec3(-halfSize, -7.f, 0.f) };
+	glm::vec3 wallColliders[4] = { glm::vec3(halfSize, 2.f, 2.f), glm::vec3(halfSize, 2.f, 2.f), glm::vec3(2.f, 2.f, halfSize), glm::vec3(2.f, 2.f, halfSize) };
+	for (int i = 0; i < 4; i++)
+	{
+		unsigned int wall = world->CreateBody(wallPositions[i], wallColliders[i], 1, false, tags->Intern("Wall"));
+		world->SetCollisionLayer(wall, LayerScenery);
+	}
+
+	TagId object = tags->Intern("Object");
+	for (int i = 0; i < cubeCount; i++)
+	{
+		glm::vec3 position(spawn(random), -8.5f, spawn(random));
+		unsigned int cube = world->CreateBody(position, glm::vec3(0.5f, 0.5f, 0.5f), 1, true, object);
+		world->ApplyForce(cube, glm::vec3(force(random), 0.f, force(random)));
+	}
+}
+
+static void WriteStats(std::ostream& out, const PhaseStats& stats)
+{
+	out << "{ \"mean\": " << stats.mean << ", \"p50\": " << stats.p50 << ", \"p90\": " << stats.p90
+		<< ", \"p95\": " << stats.p95 << ", \"p99\": " << stats.p99 << ", \"max\": " << stats.max << " }";
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (argc > 1 && (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0))
+	{
+		std::cout << Usage;
+		return 0;
+	}
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::cerr << Usage;
+		return 1;
+	}
+
+	ThreadPool* threadPool = new ThreadPool(options.threads);
+	std::ostringstream json;
+	json << "{\n  \"seed\": " << options.seed << ",\n  \"lod\": [" << options.lodNear << ", " << options.lodFar << "]" << ",\n  \"threads\": " << threadPool->GetThreadCount()
+		<< ",\n  \"steps\": " << options.steps << ",\n  \"budgetMs\": " << options.budget << ",\n  \"results\": [";
+
+	bool firstResult = true;
+	std::vector<int> largestInBudget(options.broadphases.size(), 0);
+	std::vector<bool> smallerFit(options.broadphases.size(), true);    //every count so far fit the budget
+	for (int b = 0; b < options.broadphases.size(); b++)
+	{
+		const std::string& name = options.broadphases[b];
+		for (int c = 0; c < options.counts.size(); c++)
+		{
+			int cubeCount = options.counts[c];
+			float halfSize = GetArenaHalfSize(cubeCount, options);
+			Broadphase* broadphase = CreateBroadphase(name, halfSize, threadPool);
+			if (broadphase == nullptr)
+			{
+				std::cerr << "Unknown broadphase " << name << std::endl;
+				break;
+			}
+			PhysicsWorld* world = new PhysicsWorld(broadphase, threadPool);
+			CreateArena(world, cubeCount, halfSize, options);
+
+			SimulationLod* lod = options.lodNear > 0.f ? new SimulationLod(options.lodNear, options.lodFar) : nullptr;
+			glm::vec3 viewPosition(halfSize, 20.f, halfSize);
+			glm::mat4 viewProjection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.01f, 500.f)
+				* glm::lookAt(viewPosition, glm::vec3(0.f, -8.f, 0.f), glm::vec3(0.f, 1.f, 0.f));
+			Frustum view = Frustum::FromMatrix(viewProjection);
+			double deferredSum = 0.0;
+
+			std::cerr << name << " with " << cubeCount << " cubes..." << std::flush;
+			std::vector<double> samples[PhaseCount];
+			bool tooSlow = false;
+			for (int step = 0; step < options.warmup + options.steps; step++)
+			{
+				//the game updates it once a frame, which is about once a step
+				auto start = std::chrono::high_resolution_clock::now();
+				if (lod != nullptr)
+				{
+					lod->Update(world, viewPosition, view);
+				}
+				world->Step(PhysicsWorld::BaseTimeStep);
+				auto end = std::chrono::high_resolution_clock::now();
+				double total = std::chrono::duration<double, std::milli>(end - start).count();
+
+				//one step already too slow means the rest will be too, don't wait for them
+				if (total > options.maxStepMilliseconds * 4.0)
+				{
+					tooSlow = true;
+				}
+				if (step < options.warmup && !tooSlow)
+				{
+					continue;
+				}
+
+				const StepTimings& timings = world->GetStepTimings();
+				samples[0].push_back(timings.broadphase);
+				samples[1].push_back(timings.islands);
+				samples[2].push_back(timings.narrowphase);
+				samples[3].push_back(timings.response);
+				samples[4].push_back(timings.integration);
+				samples[5].push_back(total);
+				deferredSum += world->GetDeferredCount();
+				if (tooSlow)
+				{
+					break;
+				}
+			}
+
+			PhaseStats stats[PhaseCount];
+			for (int p = 0; p < PhaseCount; p++)
+			{
+				stats[p] = GetStats(samples[p]);
+			}
+			//p95, so a single slow step out of a few dozen doesn't decide it
+			bool fitsBudget = stats[PhaseCount - 1].p95 <= options.budget;
+			smallerFit[b] = smallerFit[b] && fitsBudget;
+			if (smallerFit[b])
+			{
+				largestInBudget[b] = cubeCount;
+			}
+			std::cerr << " p50 " << stats[PhaseCount - 1].p50 << "ms, p95 " << stats[PhaseCount - 1].p95
+				<< "ms, p99 " << stats[PhaseCount - 1].p99 << "ms" << std::endl;
+
+			json << (firstResult ? "\n" : ",\n") << "    { \"broadphase\": \"" << name << "\", \"cubes\": " << cubeCount
+				<< ", \"bodies\": " << world->GetBodyCount() << ", \"samples\": " << samples[0].size()
+				<< ", \"meanDeferredBodies\": " << deferredSum / samples[0].size()
+				<< ", \"fitsBudget\": " << (fitsBudget ? "true" : "false") << ", \"phasesMs\": {";
+			for (int p = 0; p < PhaseCount; p++)
+			{
+				json << (p == 0 ? "\n" : ",\n") << "      \"" << PhaseNames[p] << "\": ";
+				WriteStats(json, stats[p]);
+			}
+			json << "\n    } }";
+			firstResult = false;
+
+			delete lod;
+			delete world;
+			delete broadphase;
+
+			//anything bigger would only be slower
+			if (stats[PhaseCount - 1].p50 > options.maxStepMilliseconds)
+			{
+				std::cerr << name << " is over " << options.maxStepMilliseconds << "ms per step, skipping bigger counts" << std::endl;
+				break;
+			}
+		}
+	}
+
+	json << "\n  ],\n  \"largestCubesInBudget\": {";
+	for (int b = 0; b < options.broadphases.size(); b++)
+	{
+		json << (b == 0 ? " " : ", ") << "\"" << options.broadphases[b] << "\": " << largestInBudget[b];
+	}
+	json << " }\n}\n";
+
+	if (options.output.empty())
+	{
+		std::cout << json.str();
+	}
+	else
+	{
+		std::ofstream file(options.output);
+		file << json.str();
+	}
+
+	delete threadPool;
+	TagRegistry::Release();
+	return 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <glm/glm.hpp>
+
+/// <summary>
+/// Axis aligned bounding box, stored as a min and max corner
+/// </summary>
+struct AABB
+{
+	glm::vec3 min;
+	glm::vec3 max;
+
+	AABB() : min(0.f, 0.f, 0.f), max(0.f, 0.f, 0.f) {}
+	AABB(glm::vec3 min, glm::vec3 max) : min(min), max(max) {}
+
+	/// <summary>
+	/// Builds a box from a center and half extents (the same position +- collider the entities use)
+	/// </summary>
+	static AABB FromCenter(glm::vec3 center, glm::vec3 extents) { return AABB(center - extents, center + extents); }
+
+	/// <summary>
+	/// The smallest box holding this one after it's been through the matrix (rotated, scaled, sheared and moved)
+	/// </summary>
+	AABB Transform(const glm::mat4& matrix) const
+	{
+		//each axis of the new box is as wide as the matrix spreads the old extents onto it
+		glm::vec3 center = glm::vec3(matrix * glm::vec4(GetCenter(), 1.f));
+		glm::vec3 extents = GetExtents();
+		glm::vec3 newExtents =
+			glm::abs(glm::vec3(matrix[0])) * extents.x +
+			glm::abs(glm::vec3(matrix[1])) * extents.y +
+			glm::abs(glm::vec3(matrix[2])) * extents.z;
+		return FromCenter(center, newExtents);
+	}
+
+	glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+	glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+	/// <summary>
+	/// True if the two boxes touch or overlap on every axis
+	/// </summary>
+	bool Overlaps(const AABB& other) const
+	{
+		return min.x <= other.max.x && max.x >= other.min.x &&
+			min.y <= other.max.y && max.y >= other.min.y &&
+			min.z <= other.max.z && max.z >= other.min.z;
+	}
+
+	/// <summary>
+	/// True if the other box is completely inside this one
+	/// </summary>
+	bool Contains(const AABB& other) const
+	{
+		return min.x <= other.min.x && max.x >= other.max.x &&
+			min.y <= other.min.y && max.y >= other.max.y &&
+			min.z <= other.min.z && max.z >= other.max.z;
+	}
+
+	/// <summary>
+	/// Moves this box by displacement and finds when it first touches the other (standing still) box.
+	/// time is the fraction of the move where they touch, normal is the face of the other box that got hit.
+	/// False if they never touch, or already overlap at the start
+	/// </summary>
+	bool Sweep(glm::vec3 displacement, const AABB& other, float& time, glm::vec3& normal) const
+	{
+		float enter = 0.f;
+		float exit = 1.f;
+		int hitAxis = -1;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (displacement[axis] == 0.f)
+			{
+				if (max[axis] < other.min[axis] || min[axis] > other.max[axis])
+				{
+					return false;
+				}
+				continue;
+			}
+
+			//when the leading face reaches the other box, and when the trailing face leaves it
+			float inverse = 1.f / displacement[axis];
+			float axisEnter = (displacement[axis] > 0.f ? other.min[axis] - max[axis] : other.max[axis] - min[axis]) * inverse;
+			float axisExit = (displacement[axis] > 0.f ? other.max[axis] - min[axis] : other.min[axis] - max[axis]) * inverse;
+
+			//already touching and moving in counts as a hit right away
+			if (axisEnter >= enter)
+			{
+				enter = axisEnter;
+				hitAxis = axis;
+			}
+			exit = glm::min(exit, axisExit);
+			if (enter > exit)
+			{
+				return false;
+			}
+		}
+
+		if (hitAxis == -1)
+		{
+			return false;
+		}
+
+		time = enter;
+		normal = glm::vec3(0.f, 0.f, 0.f);
+		normal[hitAxis] = displacement[hitAxis] > 0.f ? -1.f : 1.f;
+		return true;
+	}
+
+	bool operator==(const AABB& other) const { return min == other.min && max == other.max; }
+	bool operator!=(const AABB& other) const { return !(*this == other); }
+};
@@ -0,0 +1,504 @@
+#include "AABBTree.h"
+
+AABBTree::AABBTree(float margin, float displacementScale)
+{
+	this->margin = margin;
+	this->displacementScale = displacementScale;
+	root = -1;
+	freeList = -1;
+	leafCount = 0;
+}
+
+AABBTree::~AABBTree()
+{
+}
+
+int AABBTree::CreateProxy(const AABB& bounds, unsigned int userData)
+{
+	int proxy = AllocateNode();
+
+	glm::vec3 fat(margin, margin, margin);
+	nodes[proxy].bounds = AABB(bounds.min - fat, bounds.max + fat);
+	nodes[proxy].userData = userData;
+	nodes[proxy].height = 0;
+
+	InsertLeaf(proxy);
+	leafCount++;
+	return proxy;
+}
+
+void AABBTree::DestroyProxy(int proxy)
+{
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	leafCount--;
+}
+
+bool AABBTree::MoveProxy(int proxy, const AABB& bounds, glm::vec3 displacement)
+{
+	//small movements stay inside the fat box
+	if (nodes[proxy].bounds.Contains(bounds))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxy);
+
+	//grow the box, and stretch it the way the object is heading
+	glm::vec3 fat(margin, margin, margin);
+	AABB fatBounds(bounds.min - fat, bounds.max + fat);
+	glm::vec3 stretch = displacement * displacementScale;
+	fatBounds.min += glm::min(stretch, glm::vec3(0.f, 0.f, 0.f));
+	fatBounds.max += glm::max(stretch, glm::vec3(0.f, 0.f, 0.f));
+	nodes[proxy].bounds = fatBounds;
+
+	InsertLeaf(proxy);
+	return true;
+}
+
+void AABBTree::Query(const AABB& bounds, std::vector<unsigned int>& results)
+{
+	if (root == -1)
+	{
+		return;
+	}
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		if (!node.bounds.Overlaps(bounds))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			results.push_back(node.userData);
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+void AABBTree::QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& results)
+{
+	if (root == -1)
+	{
+		return;
+	}
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		if (!frustum.Intersects(node.bounds))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			results.push_back(node.userData);
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+void AABBTree::QueryRay(glm::vec3 origin, glm::vec3 direction, float maxDistance, std::vector<unsigned int>& results)
+{
+	if (root == -1)
+	{
+		return;
+	}
+
+	glm::vec3 inverseDirection = 1.f / direction;
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		if (RayIntersect(node.bounds, origin, inverseDirection, maxDistance) < 0.f)
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			results.push_back(node.userData);
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+bool AABBTree::RayCast(glm::vec3 origin, glm::vec3 direction, float maxDistance, RayHit& hit)
+{
+	if (root == -1)
+	{
+		return false;
+	}
+
+	glm::vec3 inverseDirection = 1.f / direction;
+	float closest = maxDistance;
+	bool found = false;
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		//skip anything further away than what we already hit
+		float distance = RayIntersect(node.bounds, origin, inverseDirection, closest);
+		if (distance < 0.f)
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			closest = distance;
+			hit.userData = node.userData;
+			hit.distance = distance;
+			found = true;
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+
+	return found;
+}
+
+//slab test
+float AABBTree::RayIntersect(const AABB& bounds, glm::vec3 origin, glm::vec3 inverseDirection, float maxDistance)
+{
+	float tMin = 0.f;
+	float tMax = maxDistance;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float t1 = (bounds.min[axis] - origin[axis]) * inverseDirection[axis];
+		float t2 = (bounds.max[axis] - origin[axis]) * inverseDirection[axis];
+		tMin = glm::max(tMin, glm::min(t1, t2));
+		tMax = glm::min(tMax, glm::max(t1, t2));
+	}
+
+	return tMin <= tMax ? tMin : -1.f;
+}
+
+int AABBTree::AllocateNode()
+{
+	if (freeList == -1)
+	{
+		Node node;
+		node.parent = -1;
+		nodes.push_back(node);
+		freeList = (int)nodes.size() - 1;
+	}
+
+	int index = freeList;
+	freeList = nodes[index].parent;
+
+	nodes[index].parent = -1;
+	nodes[index].child1 = -1;
+	nodes[index].child2 = -1;
+	nodes[index].height = 0;
+	nodes[index].userData = 0;
+	return index;
+}
+
+void AABBTree::FreeNode(int node)
+{
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	freeList = node;
+}
+
+void AABBTree::InsertLeaf(int leaf)
+{
+	if (root == -1)
+	{
+		root = leaf;
+		nodes[root].parent = -1;
+		return;
+	}
+
+	//walk down to the sibling that grows the tree's surface area the least
+	AABB leafBounds = nodes[leaf].bounds;
+	int index = root;
+	while (!nodes[index].IsLeaf())
+	{
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+
+		float area = SurfaceArea(nodes[index].bounds);
+		float combinedArea = SurfaceArea(Union(nodes[index].bounds, leafBounds));
+
+		//cost of making a new parent for this node and the leaf
+		float cost = 2.f * combinedArea;
+
+		//minimum cost of pushing the leaf further down
+		float inheritanceCost = 2.f * (combinedArea - area);
+
+		float cost1 = SurfaceArea(Union(leafBounds, nodes[child1].bounds)) + inheritanceCost;
+		if (!nodes[child1].IsLeaf())
+		{
+			cost1 -= SurfaceArea(nodes[child1].bounds);
+		}
+
+		float cost2 = SurfaceArea(Union(leafBounds, nodes[child2].bounds)) + inheritanceCost;
+		if (!nodes[child2].IsLeaf())
+		{
+			cost2 -= SurfaceArea(nodes[child2].bounds);
+		}
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	int sibling = index;
+
+	//new parent for the sibling and the leaf (allocating can move nodes, so no references are held here)
+	int oldParent = nodes[sibling].parent;
+	int newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].bounds = Union(leafBounds, nodes[sibling].bounds);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent != -1)
+	{
+		if (nodes[oldParent].child1 == sibling)
+		{
+			nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			nodes[oldParent].child2 = newParent;
+		}
+	}
+	else
+	{
+		root = newParent;
+	}
+
+	Refit(nodes[leaf].parent);
+}
+
+void AABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = -1;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	//the sibling takes the parent's place
+	if (grandParent != -1)
+	{
+		if (nodes[grandParent].child1 == parent)
+		{
+			nodes[grandParent].child1 = sibling;
+		}
+		else
+		{
+			nodes[grandParent].child2 = sibling;
+		}
+		nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		Refit(grandParent);
+	}
+	else
+	{
+		root = sibling;
+		nodes[sibling].parent = -1;
+		FreeNode(parent);
+	}
+}
+
+//walks up from a node fixing the bounds and heights, balancing as it goes
+void AABBTree::Refit(int node)
+{
+	int index = node;
+	while (index != -1)
+	{
+		index = Balance(index);
+
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+		nodes[index].height = 1 + glm::max(nodes[child1].height, nodes[child2].height);
+		nodes[index].bounds = Union(nodes[child1].bounds, nodes[child2].bounds);
+
+		index = nodes[index].parent;
+	}
+}
+
+//if one side of a node is more than 1 taller than the other, rotate the taller child up
+//returns the node now sitting where the given node was
+int AABBTree::Balance(int iA)
+{
+	if (nodes[iA].IsLeaf() || nodes[iA].height < 2)
+	{
+		return iA;
+	}
+
+	int iB = nodes[iA].child1;
+	int iC = nodes[iA].child2;
+	int balance = nodes[iC].height - nodes[iB].height;
+
+	//rotate C up
+	if (balance > 1)
+	{
+		int iF = nodes[iC].child1;
+		int iG = nodes[iC].child2;
+
+		//swap A and C
+		nodes[iC].child1 = iA;
+		nodes[iC].parent = nodes[iA].parent;
+		nodes[iA].parent = iC;
+
+		//A's old parent should point to C
+		if (nodes[iC].parent != -1)
+		{
+			if (nodes[nodes[iC].parent].child1 == iA)
+			{
+				nodes[nodes[iC].parent].child1 = iC;
+			}
+			else
+			{
+				nodes[nodes[iC].parent].child2 = iC;
+			}
+		}
+		else
+		{
+			root = iC;
+		}
+
+		//keep the taller of F and G under C
+		if (nodes[iF].height > nodes[iG].height)
+		{
+			nodes[iC].child2 = iF;
+			nodes[iA].child2 = iG;
+			nodes[iG].parent = iA;
+			nodes[iA].bounds = Union(nodes[iB].bounds, nodes[iG].bounds);
+			nodes[iC].bounds = Union(nodes[iA].bounds, nodes[iF].bounds);
+			nodes[iA].height = 1 + glm::max(nodes[iB].height, nodes[iG].height);
+			nodes[iC].height = 1 + glm::max(nodes[iA].height, nodes[iF].height);
+		}
+		else
+		{
+			nodes[iC].child2 = iG;
+			nodes[iA].child2 = iF;
+			nodes[iF].parent = iA;
+			nodes[iA].bounds = Union(nodes[iB].bounds, nodes[iF].bounds);
+			nodes[iC].bounds = Union(nodes[iA].bounds, nodes[iG].bounds);
+			nodes[iA].height = 1 + glm::max(nodes[iB].height, nodes[iF].height);
+			nodes[iC].height = 1 + glm::max(nodes[iA].height, nodes[iG].height);
+		}
+
+		return iC;
+	}
+
+	//rotate B up
+	if (balance < -1)
+	{
+		int iD = nodes[iB].child1;
+		int iE = nodes[iB].child2;
+
+		//swap A and B
+		nodes[iB].child1 = iA;
+		nodes[iB].parent = nodes[iA].parent;
+		nodes[iA].parent = iB;
+
+		//A's old parent should point to B
+		if (nodes[iB].parent != -1)
+		{
+			if (nodes[nodes[iB].parent].child1 == iA)
+			{
+				nodes[nodes[iB].parent].child1 = iB;
+			}
+			else
+			{
+				nodes[nodes[iB].parent].child2 = iB;
+			}
+		}
+		else
+		{
+			root = iB;
+		}
+
+		//keep the taller of D and E under B
+		if (nodes[iD].height > nodes[iE].height)
+		{
+			nodes[iB].child2 = iD;
+			nodes[iA].child1 = iE;
+			nodes[iE].parent = iA;
+			nodes[iA].bounds = Union(nodes[iC].bounds, nodes[iE].bounds);
+			nodes[iB].bounds = Union(nodes[iA].bounds, nodes[iD].bounds);
+			nodes[iA].height = 1 + glm::max(nodes[iC].height, nodes[iE].height);
+			nodes[iB].height = 1 + glm::max(nodes[iA].height, nodes[iD].height);
+		}
+		else
+		{
+			nodes[iB].child2 = iE;
+			nodes[iA].child1 = iD;
+			nodes[iD].parent = iA;
+			nodes[iA].bounds = Union(nodes[iC].bounds, nodes[iD].bounds);
+			nodes[iB].bounds = Union(nodes[iA].bounds, nodes[iE].bounds);
+			nodes[iA].height = 1 + glm::max(nodes[iC].height, nodes[iD].height);
+			nodes[iB].height = 1 + glm::max(nodes[iA].height, nodes[iE].height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+AABB AABBTree::Union(const AABB& a, const AABB& b)
+{
+	return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+}
+
+//half the surface area is plenty for comparing costs
+float AABBTree::SurfaceArea(const AABB& bounds)
+{
+	glm::vec3 size = bounds.max - bounds.min;
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <vector>
+#include "AABB.h"
+#include "Frustum.h"
+
+/// <summary>
+/// The closest thing a ray hit
+/// </summary>
+struct RayHit
+{
+	unsigned int userData;
+	float distance;
+};
+
+/// <summary>
+/// Dynamic bounding volume tree. Leaves store a 'fat' box that is bigger than the object,
+/// so small movements don't need the tree to change at all. Inserting picks the cheapest
+/// sibling by surface area, and the tree is kept balanced with rotations on the way back up.
+/// </summary>
+class AABBTree
+{
+private:
+	struct Node
+	{
+		AABB bounds;            //fat bounds for leaves, union of the children for everything else
+		int parent;             //also used as the next link while the node is in the free list
+		int child1;
+		int child2;
+		int height;             //0 for leaves, -1 for free nodes
+		unsigned int userData;
+
+		bool IsLeaf() const { return child1 == -1; }
+	};
+
+	std::vector<Node> nodes;
+	int root;
+	int freeList;
+	int leafCount;
+
+	float margin;           //how much each leaf box is grown by
+	float displacementScale; //how far ahead the leaf box is stretched in the direction of movement
+
+	std::vector<int> stack; //traversal stack, kept around so queries don't allocate
+
+	int AllocateNode();
+	void FreeNode(int node);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	int Balance(int node);
+	void Refit(int node);
+
+	static AABB Union(const AABB& a, const AABB& b);
+	static float SurfaceArea(const AABB& bounds);
+
+public:
+	/// <summary>
+	/// Creates an empty tree
+	/// </summary>
+	/// <param name="margin">How much to grow each leaf box by (0 for things that never move)</param>
+	/// <param name="displacementScale">How far to stretch leaf boxes along the direction they moved</param>
+	AABBTree(float margin, float displacementScale);
+
+	/// <summary>
+	/// Destruction
+	/// </summary>
+	~AABBTree();
+
+	/// <summary>
+	/// Adds an object to the tree, returns the handle for it
+	/// </summary>
+	int CreateProxy(const AABB& bounds, unsigned int userData);
+
+	/// <summary>
+	/// Removes an object from the tree
+	/// </summary>
+	void DestroyProxy(int proxy);
+
+	/// <summary>
+	/// Moves an object. Nothing happens if it is still inside its fat box, otherwise it's re-inserted
+	/// </summary>
+	/// <param name="displacement">How far it moved since the last time (used to predict where it's going)</param>
+	/// <returns>True if the tree changed</returns>
+	bool MoveProxy(int proxy, const AABB& bounds, glm::vec3 displacement);
+
+	/// <summary>
+	/// Gets the fat box stored for an object
+	/// </summary>
+	const AABB& GetFatBounds(int proxy) const { return nodes[proxy].bounds; }
+
+	/// <summary>
+	/// Gets the data given to CreateProxy
+	/// </summary>
+	unsigned int GetUserData(int proxy) const { return nodes[proxy].userData; }
+
+	/// <summary>
+	/// Gets the user data of every object whose fat box overlaps the given box
+	/// </summary>
+	void Query(const AABB& bounds, std::vector<unsigned int>& results);
+
+	/// <summary>
+	/// Gets the user data of every object whose fat box is at least partly inside the frustum
+	/// </summary>
+	void QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& results);
+
+	/// <summary>
+	/// Gets the user data of every object whose fat box a ray passes through
+	/// </summary>
+	/// <param name="direction">Normalized direction of the ray</param>
+	/// <param name="maxDistance">How far the ray goes</param>
+	void QueryRay(glm::vec3 origin, glm::vec3 direction, float maxDistance, std::vector<unsigned int>& results);
+
+	/// <summary>
+	/// Finds the closest fat box a ray hits
+	/// </summary>
+	/// <param name="direction">Normalized direction of the ray</param>
+	/// <param name="maxDistance">How far the ray goes</param>
+	/// <returns>True if anything was hit</returns>
+	bool RayCast(glm::vec3 origin, glm::vec3 direction, float maxDistance, RayHit& hit);
+
+	/// <summary>
+	/// Height of the tree (how deep a query has to go at most)
+	/// </summary>
+	int GetHeight() const { return root == -1 ? 0 : nodes[root].height; }
+
+	/// <summary>
+	/// How many objects are in the tree
+	/// </summary>
+	int GetLeafCount() const { return leafCount; }
+
+	/// <summary>
+	/// Distance along a ray to where it enters a box, or a negative value if it misses
+	/// </summary>
+	static float RayIntersect(const AABB& bounds, glm::vec3 origin, glm::vec3 inverseDirection, float maxDistance);
+};
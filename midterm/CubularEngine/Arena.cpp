@@ -0,0 +1,83 @@
+#include "Arena.h"
+#include <new>
+
+Arena::Arena()
+{
+	cursor = nullptr;
+	remaining = 0;
+	bytesInUse = 0;
+	for (int i = 0; i < MaxPooledSize / Granularity; i++)
+	{
+		freeLists[i] = nullptr;
+	}
+}
+
+Arena::~Arena()
+{
+	for (int i = 0; i < blocks.size(); i++)
+	{
+		::operator delete(blocks[i]);
+	}
+}
+
+void* Arena::Allocate(size_t size)
+{
+	size = (size + Granularity - 1) / Granularity * Granularity;
+	if (size == 0)
+	{
+		size = Granularity;
+	}
+	bytesInUse += size;
+
+	if (size > MaxPooledSize)
+	{
+		return ::operator new(size);
+	}
+
+	//reuse something that was freed at this size
+	FreeBlock*& freeList = freeLists[size / Granularity - 1];
+	if (freeList != nullptr)
+	{
+		FreeBlock* block = freeList;
+		freeList = block->next;
+		return block;
+	}
+
+	//the rest of the current block is wasted, it's never more than MaxPooledSize
+	if (remaining < size)
+	{
+		cursor = static_cast<char*>(::operator new(BlockSize));
+		remaining = BlockSize;
+		blocks.push_back(cursor);
+	}
+
+	void* memory = cursor;
+	cursor += size;
+	remaining -= size;
+	return memory;
+}
+
+void Arena::Free(void* memory, size_t size)
+{
+	if (memory == nullptr)
+	{
+		return;
+	}
+
+	size = (size + Granularity - 1) / Granularity * Granularity;
+	if (size == 0)
+	{
+		size = Granularity;
+	}
+	bytesInUse -= size;
+
+	if (size > MaxPooledSize)
+	{
+		::operator delete(memory);
+		return;
+	}
+
+	FreeBlock* block = static_cast<FreeBlock*>(memory);
+	block->next = freeLists[size / Granularity - 1];
+	freeLists[size / Granularity - 1] = block;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+/// <summary>
+/// Memory for one world's small, short lived allocations (like the contact cache's entries).
+/// Memory is carved out of big blocks, and freed allocations go on a free list for their size
+/// so the next one of that size reuses them. Nothing goes back to the system until the arena is
+/// destroyed, so a world that has warmed up never calls into the global heap, and worlds stepping
+/// on different threads never fight over its lock or share cache lines.
+/// Not thread safe, each arena belongs to one world and only that world's thread uses it
+/// </summary>
+class Arena
+{
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	static const size_t Granularity = 16;      //every allocation is rounded up to this
+	static const size_t MaxPooledSize = 1024;   //bigger ones go straight to the heap
+	static const size_t BlockSize = 64 * 1024;
+
+	std::vector<char*> blocks;
+	char* cursor;           //next free byte in the newest block
+	size_t remaining;       //bytes left after cursor
+	FreeBlock* freeLists[MaxPooledSize / Granularity];
+	size_t bytesInUse;
+
+public:
+	/// <summary>
+	/// Creates an empty arena, the first block is only allocated once something needs it
+	/// </summary>
+	Arena();
+
+	/// <summary>
+	/// Frees every block at once (whatever was allocated from it has to be gone by now)
+	/// </summary>
+	~Arena();
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	/// <summary>
+	/// Gets size bytes, aligned to 16
+	/// </summary>
+	void* Allocate(size_t size);
+
+	/// <summary>
+	/// Gives back memory from Allocate, size has to be the same as it was allocated with
+	/// </summary>
+	void Free(void* memory, size_t size);
+
+	/// <summary>
+	/// Bytes handed out and not freed yet
+	/// </summary>
+	size_t GetBytesInUse() const { return bytesInUse; }
+
+	/// <summary>
+	/// Bytes taken from the system for blocks
+	/// </summary>
+	size_t GetBytesReserved() const { return blocks.size() * BlockSize; }
+};
+
+/// <summary>
+/// Lets standard containers allocate from an Arena, a null arena uses the normal heap
+/// </summary>
+template<typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	Arena* arena;
+
+	ArenaAllocator(Arena* arena = nullptr) : arena(arena) {}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t count)
+	{
+		if (arena == nullptr)
+		{
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+		return static_cast<T*>(arena->Allocate(count * sizeof(T)));
+	}
+
+	void deallocate(T* memory, size_t count)
+	{
+		if (arena == nullptr)
+		{
+			::operator delete(memory);
+			return;
+		}
+		arena->Free(memory, count * sizeof(T));
+	}
+
+	template<typename U>
+	bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+	template<typename U>
+	bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
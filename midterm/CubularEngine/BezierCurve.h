@@ -1,5 +1,6 @@
 #pragma once
-#include "stdafx.h"
+#include <vector>
+#include <glm/glm.hpp>
 
 class BezierCurve
 {
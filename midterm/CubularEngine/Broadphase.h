@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include "AABB.h"
+
+/// <summary>
+/// One collider handed to a broadphase. The proxy id is its index in the list passed to Update
+/// </summary>
+struct BroadphaseProxy
+{
+	AABB bounds;
+	bool isStatic;  //static proxies never move and never need to be paired with each other
+	unsigned int layerBit = 1;              //1 << the proxy's collision layer
+	unsigned int collisionMask = 0xffffffff;    //layer bits it collides with
+};
+
+/// <summary>
+/// Two proxy ids whose bounds overlap (a is always the smaller id)
+/// </summary>
+struct CollisionPair
+{
+	unsigned int a;
+	unsigned int b;
+};
+
+/// <summary>
+/// Checks if two proxies could ever need a collision check
+/// </summary>
+inline bool ShouldPair(const BroadphaseProxy& a, const BroadphaseProxy& b)
+{
+	//two static objects never collide with each other, and both layers have to accept the other
+	return !(a.isStatic && b.isStatic) && (a.layerBit & b.collisionMask) != 0 && (b.layerBit & a.collisionMask) != 0;
+}
+
+/// <summary>
+/// Base class for anything that narrows down which colliders need to be checked against each other
+/// </summary>
+class Broadphase
+{
+public:
+	virtual ~Broadphase() {}
+
+	/// <summary>
+	/// Syncs the broadphase with the current bounds of every proxy
+	/// </summary>
+	/// <param name="proxies">Every proxy, indexed by id. Ids must stay the same between frames</param>
+	virtual void Update(const std::vector<BroadphaseProxy>& proxies) = 0;
+
+	/// <summary>
+	/// Fills the list with every overlapping pair (each pair only once)
+	/// </summary>
+	virtual void FindPairs(std::vector<CollisionPair>& pairs) = 0;
+};
@@ -0,0 +1,24 @@
+#include "BruteForceBroadphase.h"
+
+void BruteForceBroadphase::Update(const std::vector<BroadphaseProxy>& proxies)
+{
+	this->proxies = proxies;
+}
+
+void BruteForceBroadphase::FindPairs(std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+	for (unsigned int a = 0; a < proxies.size(); a++)
+	{
+		for (unsigned int b = a + 1; b < proxies.size(); b++)
+		{
+			if (ShouldPair(proxies[a], proxies[b]) && proxies[a].bounds.Overlaps(proxies[b].bounds))
+			{
+				CollisionPair pair;
+				pair.a = a;
+				pair.b = b;
+				pairs.push_back(pair);
+			}
+		}
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Broadphase.h"
+
+/// <summary>
+/// Checks every proxy against every other one, O(n^2).
+/// This is what collision checking cost before there were broadphases, kept around as a baseline to measure the others against
+/// </summary>
+class BruteForceBroadphase : public Broadphase
+{
+private:
+	std::vector<BroadphaseProxy> proxies;
+
+public:
+	/// <summary>
+	/// Keeps a copy of the proxies
+	/// </summary>
+	void Update(const std::vector<BroadphaseProxy>& proxies) override;
+
+	/// <summary>
+	/// Tests all n * (n - 1) / 2 pairs
+	/// </summary>
+	void FindPairs(std::vector<CollisionPair>& pairs) override;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "stdafx.h"
+#include "Frustum.h"
 
 class Camera
 {
@@ -69,6 +70,16 @@ public:
     /// </summary>
     glm::mat4 GetProjection() const { return projectionMatrix; }
 
+    /// <summary>
+    /// Gets where the camera is
+    /// </summary>
+    glm::vec3 GetPosition() const { return position; }
+
+    /// <summary>
+    /// Gets the planes of what the camera can see, as of the last Update
+    /// </summary>
+    Frustum GetFrustum() const { return Frustum::FromMatrix(projectionMatrix * viewMatrix); }
+
 
     //TODO - maybe having getters & setters for other private variables would be
     //       useful for you
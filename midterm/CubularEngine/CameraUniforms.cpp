@@ -0,0 +1,37 @@
+#include "CameraUniforms.h"
+#include <cstring>
+
+CameraUniforms::CameraUniforms()
+{
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniformData), nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, BindingPoint, buffer);
+
+	empty = true;
+}
+
+CameraUniforms::~CameraUniforms()
+{
+	glDeleteBuffers(1, &buffer);
+}
+
+void CameraUniforms::Update(Camera* camera)
+{
+	CameraUniformData data;
+	data.viewMatrix = camera->GetView();
+	data.projectionMatrix = camera->GetProjection();
+
+	//the static cameras never change, only the free cam does (while it's moving)
+	if (!empty && memcmp(&data, &uploaded, sizeof(data)) == 0)
+	{
+		return;
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), &data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	uploaded = data;
+	empty = false;
+}
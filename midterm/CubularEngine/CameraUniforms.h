@@ -0,0 +1,47 @@
+#pragma once
+#include "stdafx.h"
+#include "Camera.h"
+
+/// <summary>
+/// The camera's view and projection matrices, as laid out in the std140 CameraBlock the vertex shaders declare
+/// </summary>
+struct CameraUniformData
+{
+	glm::mat4 viewMatrix;
+	glm::mat4 projectionMatrix;
+};
+
+/// <summary>
+/// Uniform buffer holding the active camera's matrices for every program at once, so they're uploaded
+/// once a frame instead of once per object. It stays bound to BindingPoint, and every Material points
+/// its programs' CameraBlock at the same binding point when it's created
+/// </summary>
+class CameraUniforms
+{
+private:
+	GLuint buffer;
+	CameraUniformData uploaded;     //what's in the buffer, so a camera that hasn't moved isn't uploaded again
+	bool empty;
+
+public:
+	/// <summary>
+	/// Uniform buffer binding point the camera block is read from
+	/// </summary>
+	static const GLuint BindingPoint = 0;
+
+	/// <summary>
+	/// Creates the buffer and binds it to BindingPoint, needs a GL context
+	/// </summary>
+	CameraUniforms();
+
+	/// <summary>
+	/// Deletes the buffer
+	/// </summary>
+	~CameraUniforms();
+
+	/// <summary>
+	/// Uploads the camera's matrices if they changed, call it once a frame before drawing
+	/// </summary>
+	/// <param name="camera">Pointer to the rendering camera</param>
+	void Update(Camera* camera);
+};
@@ -0,0 +1,58 @@
+#include "ContactCache.h"
+#include <algorithm>
+
+ContactCache::ContactCache(Arena* arena)
+	: contacts(0, std::hash<unsigned long long>(), std::equal_to<unsigned long long>(), ArenaAllocator<std::pair<const unsigned long long, CachedContact>>(arena))
+{
+}
+
+unsigned long long ContactCache::MakeKey(unsigned int bodyA, unsigned int bodyB)
+{
+	if (bodyA > bodyB)
+	{
+		std::swap(bodyA, bodyB);
+	}
+	return ((unsigned long long)bodyA << 32) | bodyB;
+}
+
+const CachedContact* ContactCache::Find(unsigned int bodyA, unsigned int bodyB) const
+{
+	ContactMap::const_iterator found = contacts.find(MakeKey(bodyA, bodyB));
+	return found != contacts.end() ? &found->second : nullptr;
+}
+
+void ContactCache::Store(unsigned int bodyA, unsigned int bodyB, glm::vec3 normal, glm::vec3 relativePosition, float penetration, float impulse)
+{
+	//always stored from the lower handle's side
+	if (bodyA > bodyB)
+	{
+		normal = -normal;
+		relativePosition = -relativePosition;
+	}
+
+	CachedContact& contact = contacts[MakeKey(bodyA, bodyB)];
+	contact.normal = normal;
+	contact.relativePosition = relativePosition;
+	contact.penetration = penetration;
+	contact.impulse = impulse;
+}
+
+void ContactCache::NextStep()
+{
+	contacts.clear();
+}
+
+void ContactCache::RemoveBody(unsigned int body)
+{
+	for (ContactMap::iterator i = contacts.begin(); i != contacts.end();)
+	{
+		if ((unsigned int)(i->first >> 32) == body || (unsigned int)i->first == body)
+		{
+			i = contacts.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
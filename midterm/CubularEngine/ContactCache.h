@@ -0,0 +1,63 @@
+#pragma once
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include "Arena.h"
+
+/// <summary>
+/// What was left of a contact at the end of the last step it was found in
+/// </summary>
+struct CachedContact
+{
+	glm::vec3 normal;           //from the body with the lower handle to the higher one
+	glm::vec3 relativePosition; //higher handle's position - lower handle's position, when the contact was found
+	float penetration;
+	float impulse;              //total impulse the solver ended up with
+};
+
+/// <summary>
+/// Remembers the last step's contacts, keyed by the handles of the two bodies (in either order).
+/// A contact that wasn't found last step is no use for warm starting, so it's dropped.
+/// Find can be called from several threads at once, as long as nothing is storing at the same time
+/// </summary>
+class ContactCache
+{
+private:
+	typedef std::unordered_map<unsigned long long, CachedContact, std::hash<unsigned long long>, std::equal_to<unsigned long long>,
+		ArenaAllocator<std::pair<const unsigned long long, CachedContact>>> ContactMap;
+
+	ContactMap contacts;
+
+	static unsigned long long MakeKey(unsigned int bodyA, unsigned int bodyB);
+
+public:
+	/// <summary>
+	/// Creates an empty cache
+	/// </summary>
+	/// <param name="arena">Where the entries are allocated (not owned), nullptr uses the heap</param>
+	ContactCache(Arena* arena = nullptr);
+
+	/// <summary>
+	/// The cached contact between two bodies, nullptr if there isn't one
+	/// </summary>
+	const CachedContact* Find(unsigned int bodyA, unsigned int bodyB) const;
+
+	/// <summary>
+	/// Saves a contact found this step
+	/// </summary>
+	/// <param name="normal">From bodyA to bodyB</param>
+	/// <param name="relativePosition">bodyB's position - bodyA's position</param>
+	void Store(unsigned int bodyA, unsigned int bodyB, glm::vec3 normal, glm::vec3 relativePosition, float penetration, float impulse);
+
+	/// <summary>
+	/// Forgets the last step's contacts, call it before storing a step's contacts.
+	/// The entries go back to the arena's free lists, so storing the next step's doesn't touch the heap
+	/// </summary>
+	void NextStep();
+
+	/// <summary>
+	/// Drops every contact with this body, so a new body that gets its handle doesn't start with them
+	/// </summary>
+	void RemoveBody(unsigned int body);
+
+	int GetCount() const { return (int)contacts.size(); }
+};
@@ -0,0 +1,281 @@
+#include "ContactSolver.h"
+#include <algorithm>
+#include <glm/simd/platform.h>
+
+const float ContactSolver::RestitutionThreshold = 0.02f;
+const float ContactSolver::PenetrationSlop = 0.005f;
+const float ContactSolver::PositionCorrection = 0.8f;
+
+static const int BatchSize = 4;
+
+ContactSolver::ContactSolver(int iterations)
+{
+	this->iterations = iterations;
+}
+
+bool ContactSolver::MakeContact(unsigned int a, unsigned int b,
+	glm::vec3 positionA, glm::vec3 colliderA, glm::vec3 velocityA, float inverseMassA,
+	glm::vec3 positionB, glm::vec3 colliderB, glm::vec3 velocityB, float inverseMassB,
+	float restitution, Contact& contact)
+{
+	glm::vec3 delta = positionB - positionA;
+	glm::vec3 overlap = colliderA + colliderB - glm::abs(delta);
+	if (overlap.x < 0.f || overlap.y < 0.f || overlap.z < 0.f)
+	{
+		return false;
+	}
+
+	//push out along the axis that needs the least movement
+	int axis = 0;
+	if (overlap.y < overlap[axis])
+	{
+		axis = 1;
+	}
+	if (overlap.z < overlap[axis])
+	{
+		axis = 2;
+	}
+
+	glm::vec3 normal(0.f, 0.f, 0.f);
+	normal[axis] = delta[axis] < 0.f ? -1.f : 1.f;
+	BuildContact(a, b, normal, overlap[axis], velocityA, inverseMassA, velocityB, inverseMassB, restitution, contact);
+	return true;
+}
+
+void ContactSolver::BuildContact(unsigned int a, unsigned int b, glm::vec3 normal, float penetration,
+	glm::vec3 velocityA, float inverseMassA, glm::vec3 velocityB, float inverseMassB,
+	float restitution, Contact& contact)
+{
+	contact.a = a;
+	contact.b = b;
+	contact.normal = normal;
+	contact.penetration = penetration;
+	contact.inverseMassA = inverseMassA;
+	contact.inverseMassB = inverseMassB;
+	contact.normalMass = inverseMassA + inverseMassB > 0.f ? 1.f / (inverseMassA + inverseMassB) : 0.f;
+	contact.impulse = 0.f;
+
+	//only bounce off things that are actually coming closer
+	float approachSpeed = glm::dot(velocityB - velocityA, contact.normal);
+	contact.velocityBias = approachSpeed < -RestitutionThreshold ? -restitution * approachSpeed : 0.f;
+}
+
+void ContactSolver::Solve(Contact* contacts, int count, glm::vec3* velocities, glm::vec3* positions, int* bodyLevels)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	//a contact goes one level after the last contact that used either of its bodies
+	for (int i = 0; i < count; i++)
+	{
+		bodyLevels[contacts[i].a] = -1;
+		if (contacts[i].b != StaticBody)
+		{
+			bodyLevels[contacts[i].b] = -1;
+		}
+	}
+
+	contactLevels.resize(count);
+	int levelCount = 0;
+	for (int i = 0; i < count; i++)
+	{
+		const Contact& contact = contacts[i];
+		int level = bodyLevels[contact.a];
+		if (contact.b != StaticBody)
+		{
+			level = std::max(level, bodyLevels[contact.b]);
+		}
+		level++;
+
+		contactLevels[i] = level;
+		bodyLevels[contact.a] = level;
+		if (contact.b != StaticBody)
+		{
+			bodyLevels[contact.b] = level;
+		}
+		levelCount = std::max(levelCount, level + 1);
+	}
+
+	//counting sort by level, keeping the contacts in order inside each level
+	levelStarts.assign(levelCount + 1, 0);
+	for (int i = 0; i < count; i++)
+	{
+		levelStarts[contactLevels[i] + 1]++;
+	}
+	for (int level = 0; level < levelCount; level++)
+	{
+		levelStarts[level + 1] += levelStarts[level];
+	}
+
+	sorted.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		sorted[levelStarts[contactLevels[i]]++] = contacts[i];
+	}
+	for (int level = levelCount; level > 0; level--)
+	{
+		levelStarts[level] = levelStarts[level - 1];
+	}
+	levelStarts[0] = 0;
+
+	//warm start with whatever impulse the contacts came with
+	for (int i = 0; i < count; i++)
+	{
+		const Contact& contact = sorted[i];
+		velocities[contact.a] -= contact.normal * (contact.impulse * contact.inverseMassA);
+		if (contact.b != StaticBody)
+		{
+			velocities[contact.b] += contact.normal * (contact.impulse * contact.inverseMassB);
+		}
+	}
+
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		for (int level = 0; level < levelCount; level++)
+		{
+			for (int i = levelStarts[level]; i < levelStarts[level + 1]; i += BatchSize)
+			{
+				SolveVelocities(&sorted[i], std::min(BatchSize, levelStarts[level + 1] - i), velocities);
+			}
+		}
+	}
+
+	for (int level = 0; level < levelCount; level++)
+	{
+		SolvePositions(&sorted[levelStarts[level]], levelStarts[level + 1] - levelStarts[level], positions);
+	}
+
+	std::copy(sorted.begin(), sorted.begin() + count, contacts);
+}
+
+//one batch of up to 4 contacts that share no moving body:
+//impulse = (bias - vn) / (inverseMassA + inverseMassB), clamped so the total never pulls the bodies together
+void ContactSolver::SolveVelocities(Contact* contacts, int count, glm::vec3* velocities)
+{
+	//gather the batch into one array per value, empty lanes get no mass so they do nothing
+	alignas(16) float velocityAX[BatchSize], velocityAY[BatchSize], velocityAZ[BatchSize];
+	alignas(16) float velocityBX[BatchSize], velocityBY[BatchSize], velocityBZ[BatchSize];
+	alignas(16) float normalX[BatchSize], normalY[BatchSize], normalZ[BatchSize];
+	alignas(16) float inverseMassA[BatchSize], inverseMassB[BatchSize], normalMass[BatchSize];
+	alignas(16) float velocityBias[BatchSize], impulse[BatchSize];
+
+	for (int lane = 0; lane < BatchSize; lane++)
+	{
+		glm::vec3 velocityA(0.f, 0.f, 0.f);
+		glm::vec3 velocityB(0.f, 0.f, 0.f);
+		glm::vec3 normal(0.f, 0.f, 0.f);
+		inverseMassA[lane] = 0.f;
+		inverseMassB[lane] = 0.f;
+		normalMass[lane] = 0.f;
+		velocityBias[lane] = 0.f;
+		impulse[lane] = 0.f;
+
+		if (lane < count)
+		{
+			const Contact& contact = contacts[lane];
+			velocityA = velocities[contact.a];
+			if (contact.b != StaticBody)
+			{
+				velocityB = velocities[contact.b];
+			}
+			normal = contact.normal;
+			inverseMassA[lane] = contact.inverseMassA;
+			inverseMassB[lane] = contact.inverseMassB;
+			normalMass[lane] = contact.normalMass;
+			velocityBias[lane] = contact.velocityBias;
+			impulse[lane] = contact.impulse;
+		}
+
+		velocityAX[lane] = velocityA.x;
+		velocityAY[lane] = velocityA.y;
+		velocityAZ[lane] = velocityA.z;
+		velocityBX[lane] = velocityB.x;
+		velocityBY[lane] = velocityB.y;
+		velocityBZ[lane] = velocityB.z;
+		normalX[lane] = normal.x;
+		normalY[lane] = normal.y;
+		normalZ[lane] = normal.z;
+	}
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	__m128 nx = _mm_load_ps(normalX);
+	__m128 ny = _mm_load_ps(normalY);
+	__m128 nz = _mm_load_ps(normalZ);
+	__m128 vax = _mm_load_ps(velocityAX);
+	__m128 vay = _mm_load_ps(velocityAY);
+	__m128 vaz = _mm_load_ps(velocityAZ);
+	__m128 vbx = _mm_load_ps(velocityBX);
+	__m128 vby = _mm_load_ps(velocityBY);
+	__m128 vbz = _mm_load_ps(velocityBZ);
+
+	//relative velocity along the normal
+	__m128 vn = _mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(_mm_sub_ps(vbx, vax), nx),
+		_mm_mul_ps(_mm_sub_ps(vby, vay), ny)),
+		_mm_mul_ps(_mm_sub_ps(vbz, vaz), nz));
+
+	__m128 oldImpulse = _mm_load_ps(impulse);
+	__m128 lambda = _mm_mul_ps(_mm_load_ps(normalMass), _mm_sub_ps(_mm_load_ps(velocityBias), vn));
+	__m128 newImpulse = _mm_max_ps(_mm_add_ps(oldImpulse, lambda), _mm_setzero_ps());
+	lambda = _mm_sub_ps(newImpulse, oldImpulse);
+
+	__m128 lambdaA = _mm_mul_ps(lambda, _mm_load_ps(inverseMassA));
+	__m128 lambdaB = _mm_mul_ps(lambda, _mm_load_ps(inverseMassB));
+	_mm_store_ps(velocityAX, _mm_sub_ps(vax, _mm_mul_ps(nx, lambdaA)));
+	_mm_store_ps(velocityAY, _mm_sub_ps(vay, _mm_mul_ps(ny, lambdaA)));
+	_mm_store_ps(velocityAZ, _mm_sub_ps(vaz, _mm_mul_ps(nz, lambdaA)));
+	_mm_store_ps(velocityBX, _mm_add_ps(vbx, _mm_mul_ps(nx, lambdaB)));
+	_mm_store_ps(velocityBY, _mm_add_ps(vby, _mm_mul_ps(ny, lambdaB)));
+	_mm_store_ps(velocityBZ, _mm_add_ps(vbz, _mm_mul_ps(nz, lambdaB)));
+	_mm_store_ps(impulse, newImpulse);
+#else
+	for (int lane = 0; lane < BatchSize; lane++)
+	{
+		float vn = (velocityBX[lane] - velocityAX[lane]) * normalX[lane] +
+			(velocityBY[lane] - velocityAY[lane]) * normalY[lane] +
+			(velocityBZ[lane] - velocityAZ[lane]) * normalZ[lane];
+
+		float lambda = normalMass[lane] * (velocityBias[lane] - vn);
+		float newImpulse = std::max(impulse[lane] + lambda, 0.f);
+		lambda = newImpulse - impulse[lane];
+		impulse[lane] = newImpulse;
+
+		velocityAX[lane] -= normalX[lane] * lambda * inverseMassA[lane];
+		velocityAY[lane] -= normalY[lane] * lambda * inverseMassA[lane];
+		velocityAZ[lane] -= normalZ[lane] * lambda * inverseMassA[lane];
+		velocityBX[lane] += normalX[lane] * lambda * inverseMassB[lane];
+		velocityBY[lane] += normalY[lane] * lambda * inverseMassB[lane];
+		velocityBZ[lane] += normalZ[lane] * lambda * inverseMassB[lane];
+	}
+#endif
+
+	//scatter back, static bodies are shared between islands and never written
+	for (int lane = 0; lane < count; lane++)
+	{
+		Contact& contact = contacts[lane];
+		velocities[contact.a] = glm::vec3(velocityAX[lane], velocityAY[lane], velocityAZ[lane]);
+		if (contact.b != StaticBody)
+		{
+			velocities[contact.b] = glm::vec3(velocityBX[lane], velocityBY[lane], velocityBZ[lane]);
+		}
+		contact.impulse = impulse[lane];
+	}
+}
+
+//pushes overlapping bodies apart, split by mass so the lighter one moves more
+void ContactSolver::SolvePositions(Contact* contacts, int count, glm::vec3* positions)
+{
+	for (int i = 0; i < count; i++)
+	{
+		const Contact& contact = contacts[i];
+		float correction = std::max(contact.penetration - PenetrationSlop, 0.f) * PositionCorrection * contact.normalMass;
+
+		positions[contact.a] -= contact.normal * (correction * contact.inverseMassA);
+		if (contact.b != StaticBody)
+		{
+			positions[contact.b] += contact.normal * (correction * contact.inverseMassB);
+		}
+	}
+}
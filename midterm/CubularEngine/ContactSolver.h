@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+/// <summary>
+/// One touching pair of boxes, found by the narrowphase and worked on by the solver
+/// </summary>
+struct Contact
+{
+	unsigned int a;         //dense index of the moving body
+	unsigned int b;         //dense index of the other body, or ContactSolver::StaticBody if it can't move
+	glm::vec3 normal;       //axis of least penetration, pointing from a to b
+	float penetration;
+	float inverseMassA;
+	float inverseMassB;
+	float normalMass;       //1 / (inverseMassA + inverseMassB)
+	float velocityBias;     //separating speed the bounce should end up with
+	float impulse;          //total impulse applied along the normal, can start with last step's (warm starting)
+	unsigned int id;        //whatever the caller finds the contact again with, the solver leaves it alone
+};
+
+/// <summary>
+/// Sequential impulse solver for the contacts of one island.
+/// The contacts are split into levels where no moving body shows up twice, and every level is
+/// solved 4 contacts at a time with SIMD. Contacts in a level can't affect each other, so the result
+/// only depends on the levels and not on the order inside them.
+/// Not thread safe, give every thread its own solver.
+/// </summary>
+class ContactSolver
+{
+private:
+	int iterations;
+
+	std::vector<int> contactLevels;
+	std::vector<int> levelStarts;
+	std::vector<Contact> sorted;    //contacts grouped by level
+
+	void SolveVelocities(Contact* contacts, int count, glm::vec3* velocities);
+	void SolvePositions(Contact* contacts, int count, glm::vec3* positions);
+
+public:
+	static const unsigned int StaticBody = 0xffffffff;
+
+	//approach speeds (per step) below this don't bounce, so resting bodies settle instead of jittering
+	static const float RestitutionThreshold;
+
+	//how much overlap is left alone, and how much of the rest is pushed out each step
+	static const float PenetrationSlop;
+	static const float PositionCorrection;
+
+	/// <summary>
+	/// Creates a solver
+	/// </summary>
+	/// <param name="iterations">How many times every contact is solved per step, more is stiffer</param>
+	ContactSolver(int iterations);
+
+	/// <summary>
+	/// Builds a contact between two overlapping boxes (a has to be able to move), false if they don't overlap
+	/// </summary>
+	static bool MakeContact(unsigned int a, unsigned int b,
+		glm::vec3 positionA, glm::vec3 colliderA, glm::vec3 velocityA, float inverseMassA,
+		glm::vec3 positionB, glm::vec3 colliderB, glm::vec3 velocityB, float inverseMassB,
+		float restitution, Contact& contact);
+
+	/// <summary>
+	/// Builds a contact from a normal and penetration that are already known (like last step's)
+	/// </summary>
+	static void BuildContact(unsigned int a, unsigned int b, glm::vec3 normal, float penetration,
+		glm::vec3 velocityA, float inverseMassA, glm::vec3 velocityB, float inverseMassB,
+		float restitution, Contact& contact);
+
+	/// <summary>
+	/// Solves the contacts, changing the velocities and positions of the moving bodies.
+	/// Each contact's starting impulse is applied first, so a good guess (last step's) needs fewer iterations.
+	/// The contacts come back in the order they were solved in, with their final impulses
+	/// </summary>
+	/// <param name="bodyLevels">Scratch space with an entry per body, only the entries for these contacts' bodies are used</param>
+	void Solve(Contact* contacts, int count, glm::vec3* velocities, glm::vec3* positions, int* bodyLevels);
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+/// <summary>
+/// Fixed size queue that any number of threads can push to at once without locking, and one thread pops from.
+/// Every slot has a sequence number saying whose turn it is: a pusher claims a slot by bumping the tail,
+/// writes it and then hands it to the popper by bumping the slot's sequence. When it is full pushes are
+/// dropped (and counted) instead of waiting, so a burst of events can never hold up whoever is pushing
+/// </summary>
+template<typename T>
+class EventQueue
+{
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::unique_ptr<Slot[]> slots;
+	size_t mask;
+
+	//pushers and the popper each get their own cache line
+	alignas(64) std::atomic<size_t> tail;
+	alignas(64) size_t head;
+	std::atomic<size_t> dropped;
+
+public:
+	/// <summary>
+	/// Creates an empty queue
+	/// </summary>
+	/// <param name="capacity">Most events it holds before pushes get dropped, rounded up to a power of two</param>
+	EventQueue(size_t capacity)
+	{
+		size_t size = 2;
+		while (size < capacity)
+		{
+			size *= 2;
+		}
+
+		slots.reset(new Slot[size]);
+		for (size_t i = 0; i < size; i++)
+		{
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		mask = size - 1;
+		tail.store(0, std::memory_order_relaxed);
+		head = 0;
+		dropped.store(0, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Adds an event, safe from any thread. False (and the event is dropped) if the queue is full
+	/// </summary>
+	bool Push(const T& value)
+	{
+		size_t position = tail.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Slot& slot = slots[position & mask];
+			size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)position;
+			if (difference == 0)
+			{
+				//the slot is free, try to claim it (position is reloaded if someone else got there first)
+				if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					slot.value = value;
+					slot.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0)
+			{
+				//still holding an event from a lap ago, the popper hasn't caught up
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				position = tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Takes the oldest event off, only ever call it from one thread at a time. False if there's nothing to take
+	/// </summary>
+	bool Pop(T& value)
+	{
+		Slot& slot = slots[head & mask];
+		if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+		{
+			return false;
+		}
+
+		value = slot.value;
+		slot.sequence.store(head + mask + 1, std::memory_order_release);
+		head++;
+		return true;
+	}
+
+	/// <summary>
+	/// How many events have been dropped because the queue was full
+	/// </summary>
+	size_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+};
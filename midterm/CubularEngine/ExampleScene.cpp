@@ -0,0 +1,586 @@
+#include "ExampleScene.h"
+#include "Octree.h"
+#include "SweepAndPrune.h"
+#include "TreeBroadphase.h"
+#include "SpatialHashGrid.h"
+#include "BruteForceBroadphase.h"
+
+// ========================================================== creates the broadphase for the linear momentum example
+Broadphase* CreateBroadphase(BroadphaseType type, ThreadPool* threadPool)
+{
+	switch (type)
+	{
+	case BroadphaseType::Octree:
+		//persistent octree around the linear momentum example (big enough to cover the floor)
+		return new Octree(glm::vec3(0.f, -7.f, -70.f), 128.f, 6, 8);
+	case BroadphaseType::SpatialHash:
+		//cells twice the size of the cubes in the example, so most cubes cover one to a few cells
+		return new SpatialHashGrid(threadPool, 2.f);
+	case BroadphaseType::AABBTree:
+		//the floor and walls go in their own static tree
+		return new TreeBroadphase(0.1f);
+	case BroadphaseType::BruteForce:
+		return new BruteForceBroadphase();
+	case BroadphaseType::SweepAndPrune:
+	default:
+		return new SweepAndPrune();
+	}
+}
+
+const char* GetBroadphaseName(BroadphaseType type)
+{
+	switch (type)
+	{
+	case BroadphaseType::Octree:
+		return "an octree";
+	case BroadphaseType::SpatialHash:
+		return "a spatial hash grid";
+	case BroadphaseType::AABBTree:
+		return "an AABB tree";
+	case BroadphaseType::BruteForce:
+		return "brute force (every body against every other)";
+	case BroadphaseType::SweepAndPrune:
+	default:
+		return "sweep and prune";
+	}
+}
+
+ExampleScene::ExampleScene(PhysicsWorld* world, unsigned int seed, float forceScale)
+{
+	this->world = world;
+	this->seed = seed;
+	this->forceScale = forceScale;
+	random.seed(seed);
+
+	bezierCubeTime = 0;
+	bezierCubeStep = 1.f / 500.f;
+	bezierDirForward = true;
+
+	scalingDir = 0;
+	scaleAmount = 1.f;
+
+	shearDir = 0;
+	shearAmount = 0.f;
+
+	lerpStart = glm::vec3(50.f, 10.f, 5.f);
+	lerpEnd = glm::vec3(60.f, 5.f, 10.f);
+	lerpTime = 0;
+	lerpStep = 1.f / 100.f;
+	lerpDirForward = true;
+
+	slerpStart = glm::vec3(0.f, 0.f, 0.f);
+	slerpEnd = glm::vec3(0.f, 0.15f, 0.15f);
+	slerpTime = 0;
+	slerpStep = 1.f / 100.f;
+	slerpDirForward = true;
+
+	//==================== create bezier cubes==================================
+	glm::vec2 curveStart = glm::vec2(20.f, 10.f);
+	bezierCurve = new BezierCurve(curveStart, glm::vec2(10, 10), glm::vec2(5, 20), glm::vec2(25, 20));
+	CreateBezierExample();
+
+	bezierCube = new GameEntity(
+		world,
+		glm::vec3(curveStart.x, curveStart.y, 5),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(0.4f, 0.4f, 0.4f),
+		glm::vec3(0.13f, 0.73f, 0.27f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	entities.push_back(bezierCube);
+
+	//============ create scaling example=============================
+	scaleExample = new GameEntity(
+		world,
+		glm::vec3(40, 5, 5),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(1.f, 1.f, 1.f),
+		glm::vec3(0.8f, 0.8f, 0.8f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	entities.push_back(scaleExample);
+
+	//============ create shearing example=============================
+	shearingExample = new GameEntity(
+		world,
+		glm::vec3(90, 5, 5),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(1.f, 1.f, 1.f),
+		glm::vec3(0.8f, 0.8f, 0.8f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	entities.push_back(shearingExample);
+
+	//================== create lerp example ========================
+
+	SetupLERPExample();
+
+	//moving var
+	lerpExample = new GameEntity(
+		world,
+		lerpStart,
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(0.5f, 0.5f, 0.5f),
+		glm::vec3(0.8f, 0.8f, 0.8f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	entities.push_back(lerpExample);
+
+	//================== create slerp example ========================
+
+	SetupSLERPExample();
+
+	//moving var
+	slerpExample = new GameEntity(
+		world,
+		glm::vec3(75.f, 6.f, 5.f),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(2.f, 2.f, 2.f),
+		glm::vec3(0.8f, 0.8f, 0.8f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	entities.push_back(slerpExample);
+
+	//create floor
+	GameEntity* floor = new GameEntity(
+		world,
+		glm::vec3(0.f, -10.f, 0.f),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(100.f, 1.f, 100.f),
+		glm::vec3(0.2f, 0.2f, 0.2f),
+		false,
+		glm::vec3(100.f, 1.f, 100.f),
+		1,
+		"Floor",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	entities.push_back(floor);
+	world->SetCollisionLayer(floor->GetBody(), LayerScenery);
+
+	//======================================= create no gravity linear momentum example =======================
+
+	CreatePhysicsExample1();
+
+	//============================================= create gravity example =================================
+	gravityExample = new GameEntity(
+		world,
+		glm::vec3(40.f, 50.f, -70.f),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(2.f, 2.f, 2.f),
+		glm::vec3(0.8f, 0.8f, 0.8f),
+		true,
+		glm::vec3(2.f, 2.f, 2.f),
+		1,
+		"SoundCube",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+	entities.push_back(gravityExample);
+	world->SetReportCollisions(gravityExample->GetBody(), true);   //bounces play a sound
+}
+
+ExampleScene::~ExampleScene()
+{
+	for (int i = 0; i < entities.size(); i++)
+	{
+		delete entities[i];
+	}
+
+	delete bezierCurve;
+}
+
+void ExampleScene::Update()
+{
+	//update bezier example
+	UpdateBezierExample();
+
+	//update scaling example
+	UpdateScaleExample();
+
+	//update shearing example
+	UpdateSheerExample();
+
+	//update lerp example
+	UpdateLERPExample();
+
+	//update slerp example
+	UpdateSLERPExample();
+
+	//update gravity example
+	UpdateGravityExample();
+}
+
+void ExampleScene::UpdateEntities(float interpolation)
+{
+	for (int i = 0; i < entities.size(); i++)
+	{
+		entities[i]->Update(interpolation);
+	}
+}
+
+// ========================================================== create bezier curve example
+void ExampleScene::CreateBezierExample()
+{
+	int pointCount = 100;
+
+	float interval = (float)(1.f / pointCount);
+	//create line of objects to show the curve
+	for (int i = 0; i < pointCount; i++)
+	{
+		float t = interval * i;
+		glm::vec2 pos = bezierCurve->GetPoint(t);
+		GameEntity* myGameEntity = new GameEntity(
+			world,
+			glm::vec3(pos.x, pos.y, 5),
+			glm::vec3(0.f, 0.f, 0.f),
+			glm::vec3(0.02f, 0.02f, 0.02f),
+			glm::vec3(0.8f, 0.8f, 0.8f),
+			false,
+			glm::vec3(0.f, 0.f, 0.f),
+			0,
+			"Object",
+			glm::vec3(0.f, 0.f, 0.f)
+		);
+		entities.push_back(myGameEntity);
+	}
+
+	glm::vec2 pos = bezierCurve->GetPoint(0);
+	GameEntity* start = new GameEntity(
+		world,
+		glm::vec3(pos.x, pos.y, 5),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(0.1f, 0.1f, 0.1f),
+		glm::vec3(1.0f, 0.f, 0.0f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	pos = bezierCurve->GetPoint(1);
+	GameEntity* end = new GameEntity(
+		world,
+		glm::vec3(pos.x, pos.y, 5),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(0.1f, 0.1f, 0.1f),
+		glm::vec3(0.0f, 1.f, 0.0f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	entities.push_back(start);
+	entities.push_back(end);
+}
+
+// ========================================================== update bezier curve example
+void ExampleScene::UpdateBezierExample()
+{
+	bezierCubeTime += (bezierDirForward) ? bezierCubeStep : -bezierCubeStep;
+
+	if (bezierCubeTime >= 1.f) { bezierCubeTime = 1.f; bezierDirForward = false; }
+	else if (bezierCubeTime <= 0) { bezierCubeTime = 0.f; bezierDirForward = true; }
+
+
+	glm::vec2 newPos = bezierCurve->GetPoint(bezierCubeTime);
+
+	bezierCube->SetPosition(glm::vec3(newPos.x, newPos.y, 5));
+}
+
+// ========================================================== update Scale example
+void ExampleScene::UpdateScaleExample()
+{
+	glm::vec3 scaleSet = glm::vec3(1.f, 1.f, 1.f);
+	scaleAmount += (scalingDir % 2 == 0) ? 0.01f : -0.01f;
+
+	if (scaleAmount >= 2.f || scaleAmount <= 1.f)
+	{
+		scaleAmount = (scaleAmount >= 2.f) ? 2.f : 1.f;
+		scalingDir++;
+		if (scalingDir == 6) { scalingDir = 0; }
+	}
+
+	if (scalingDir == 0 || scalingDir == 1)
+	{
+		scaleSet.x = scaleAmount;
+	}
+	else if (scalingDir == 2 || scalingDir == 3)
+	{
+		scaleSet.y = scaleAmount;
+	}
+	else
+	{
+		scaleSet.z = scaleAmount;
+	}
+
+	//update to new scale and rotation
+	scaleExample->scale = scaleSet;
+	scaleExample->eulerAngles.y += 0.009f;
+	scaleExample->eulerAngles.x += 0.006f;
+	scaleExample->eulerAngles.z += 0.003f;
+}
+
+// ========================================================== update Sheer example
+void ExampleScene::UpdateSheerExample()
+{
+	glm::vec3 shearSet = glm::vec3(0.f, 0.f, 0.f);
+	shearAmount += (shearDir % 2 == 0) ? 0.01f : -0.01f;
+	if (shearAmount >= 1.f || shearAmount <= 0.f)
+	{
+		shearAmount = (shearAmount >= 1.f) ? 1.f : 0.f;
+		shearDir++;
+		if (shearDir == 6) { shearDir = 0; }
+	}
+
+	if (shearDir == 0 || shearDir == 1)
+	{
+		shearSet.x = shearAmount;
+	}
+	else if (shearDir == 2 || shearDir == 3)
+	{
+		shearSet.y = shearAmount;
+	}
+	else
+	{
+		shearSet.z = shearAmount;
+	}
+
+	shearingExample->shear = shearSet;
+}
+
+// ========================================================== create LERP example
+void ExampleScene::SetupLERPExample()
+{
+	int pointCount = 100;
+	float step = 1.f / pointCount;
+
+	//create line of objects to show line of LERP
+	for (int i = 0; i < pointCount; i++)
+	{
+		float t = step * i;
+
+		GameEntity* obj = new GameEntity(
+			world,
+			interpolate.LERP(lerpStart, lerpEnd, t),
+			glm::vec3(0.f, 0.f, 0.f),
+			glm::vec3(.02f, .02f, .02f),
+			glm::vec3(0.8f, 0.8f, 0.8f),
+			false,
+			glm::vec3(0.f, 0.f, 0.f),
+			0,
+			"Object",
+			glm::vec3(0.f, 0.f, 0.f)
+		);
+
+		entities.push_back(obj);
+	}
+
+	//start / end pos
+	GameEntity* lerpStartObj = new GameEntity(
+		world,
+		lerpStart,
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(.1f, .1f, .1f),
+		glm::vec3(1.0f, 0.0f, 0.0f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+	GameEntity* lerpEndObj = new GameEntity(
+		world,
+		lerpEnd,
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(.1f, .1f, .1f),
+		glm::vec3(0.0f, 1.0f, 0.0f),
+		false,
+		glm::vec3(0.f, 0.f, 0.f),
+		0,
+		"Object",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	entities.push_back(lerpStartObj);
+	entities.push_back(lerpEndObj);
+}
+
+// ========================================================== create SLERP example
+void ExampleScene::SetupSLERPExample()
+{
+	int pointCount = 100;
+	float step = 1.f / pointCount;
+
+	for (int i = 0; i < pointCount; i++)
+	{
+		float t = step * i;
+		glm::vec3 pos = interpolate.SLERP(slerpStart, slerpEnd, t);
+	}
+}
+
+// ========================================================== update LERP example
+void ExampleScene::UpdateLERPExample()
+{
+	lerpTime += (lerpDirForward) ? lerpStep : -lerpStep;
+	if (lerpTime >= 1.f || lerpTime <= 0.f) { lerpDirForward = !lerpDirForward; }
+
+	glm::vec3 pos = interpolate.LERP(lerpStart, lerpEnd, lerpTime);
+
+	lerpExample->SetPosition(pos);
+}
+
+// ========================================================== update SLERP rotation example
+void ExampleScene::UpdateSLERPExample()
+{
+	slerpTime += (slerpDirForward) ? slerpStep : -slerpStep;
+	if (slerpTime >= 1.f || slerpTime <= 0.f) { slerpDirForward = !slerpDirForward; }
+
+	glm::vec3 angle = interpolate.SLERP(slerpStart, slerpEnd, slerpTime);
+
+	slerpExample->eulerAngles = angle;
+}
+
+// ========================================================== create linear momentum example 1 (box)
+void ExampleScene::CreatePhysicsExample1()
+{
+	GameEntity* wall1 = new GameEntity(
+		world,
+		glm::vec3(0.f, -7.f, -50.f),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(20.f, 2.f, 2.0f),
+		glm::vec3(0.4f, 0.4f, 0.4f),
+		false,
+		glm::vec3(20.f, 2.f, 2.f),
+		1,
+		"Wall",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	GameEntity* wall2 = new GameEntity(
+		world,
+		glm::vec3(0.f, -7.f, -90.f),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(20.f, 2.f, 2.f),
+		glm::vec3(0.4f, 0.4f, 0.4f),
+		false,
+		glm::vec3(20.f, 2.f, 2.f),
+		1,
+		"Wall",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	GameEntity* wall3 = new GameEntity(
+		world,
+		glm::vec3(-20.f, -7.f, -70.f),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(2.f, 2.f, 20.f),
+		glm::vec3(0.4f, 0.4f, 0.4f),
+		false,
+		glm::vec3(2.f, 2.f, 20.f),
+		1,
+		"Wall",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	GameEntity* wall4 = new GameEntity(
+		world,
+		glm::vec3(20.f, -7.f, -70.f),
+		glm::vec3(0.f, 0.f, 0.f),
+		glm::vec3(2.f, 2.f, 20.f),
+		glm::vec3(0.4f, 0.4f, 0.4f),
+		false,
+		glm::vec3(2.f, 2.f, 20.f),
+		1,
+		"Wall",
+		glm::vec3(0.f, 0.f, 0.f)
+	);
+
+	//add 4 walls
+	entities.push_back(wall1);
+	entities.push_back(wall2);
+	entities.push_back(wall3);
+	entities.push_back(wall4);
+
+	//scenery never needs to be checked against other scenery
+	world->SetCollisionLayer(wall1->GetBody(), LayerScenery);
+	world->SetCollisionLayer(wall2->GetBody(), LayerScenery);
+	world->SetCollisionLayer(wall3->GetBody(), LayerScenery);
+	world->SetCollisionLayer(wall4->GetBody(), LayerScenery);
+
+	//create a bunch of entities to move around (and apply random forces to each one)
+	int cubeCount = 35;
+
+	for (int i = 0; i < cubeCount; i++)
+	{
+		float randomZ = RandomRange(-85.f, -55.f);
+
+		glm::vec3 pos = glm::vec3((0.7f * i) + 1.f - 18.f, -6.f, randomZ);
+		GameEntity* cube = new GameEntity(
+			world,
+			pos,
+			glm::vec3(0.f, 0.f, 0.f),
+			glm::vec3(0.5f, 0.5f, 0.5f),
+			glm::vec3(0.7f, 0.7f, 0.7f),
+			true,
+			glm::vec3(0.5f, 0.5f, 0.5f),
+			1,
+			"Object",
+			glm::vec3(0.f, 0.f, 0.f)
+		);
+
+		float dirX = RandomRange(-0.5f, 0.5f);
+		float dirZ = RandomRange(-0.5f, 0.5f);
+
+		glm::vec3 randomForce = glm::vec3(dirX, 0.0f, 0.0f) * forceScale;
+
+		cube->ApplyForce(randomForce);
+
+		entities.push_back(cube);
+	}
+}
+
+// ========================================================== random number between min and max
+float ExampleScene::RandomRange(float min, float max)
+{
+	//done by hand rather than with std::uniform_real_distribution, which gives different numbers on different standard libraries
+	return min + (max - min) * (float)(random() / 4294967296.0);
+}
+
+// ========================================================== update gravity example
+void ExampleScene::UpdateGravityExample()
+{
+	glm::vec3 position = gravityExample->GetPosition();
+	if (position.y <= -7.f)
+	{
+		gravityExample->SetPosition(glm::vec3(position.x, -7.f, position.z));
+		gravityExample->ApplyForce(glm::vec3(0.f, 2.f, 0.f));
+	}
+}
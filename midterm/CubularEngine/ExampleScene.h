@@ -0,0 +1,134 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <glm/glm.hpp>
+#include "GameEntity.h"
+#include "PhysicsWorld.h"
+#include "BezierCurve.h"
+#include "Interpolate.h"
+
+/// <summary>
+/// The broadphases that can be used for the linear momentum example
+/// </summary>
+enum class BroadphaseType
+{
+	Octree,
+	SweepAndPrune,
+	AABBTree,
+	SpatialHash,
+	BruteForce      //every body against every other, only for comparing
+};
+
+/// <summary>
+/// Creates a broadphase sized for the example scene
+/// </summary>
+/// <param name="threadPool">Threads the spatial hash can use (not owned)</param>
+Broadphase* CreateBroadphase(BroadphaseType type, ThreadPool* threadPool);
+
+/// <summary>
+/// Readable name of a broadphase, for printing
+/// </summary>
+const char* GetBroadphaseName(BroadphaseType type);
+
+/// <summary>
+/// Every example from the test scene (bezier curve, scaling, shearing, LERP, SLERP, linear momentum and gravity).
+/// Only the simulation side lives here, so it runs the same with or without a window to draw it in
+/// </summary>
+class ExampleScene
+{
+private:
+	PhysicsWorld* world;
+	std::vector<GameEntity*> entities;
+
+	//everything random in the scene comes from here, so the same seed always gives the same scene
+	unsigned int seed;
+	std::mt19937 random;
+	float forceScale;   //how hard the linear momentum example's cubes get pushed
+
+	//interpolation declaration
+	Interpolate interpolate;
+
+	//bezier cube example vars
+	BezierCurve* bezierCurve;
+	GameEntity* bezierCube;
+	float bezierCubeTime;
+	float bezierCubeStep;
+	bool bezierDirForward;
+
+	//scaling example
+	GameEntity* scaleExample;
+	int scalingDir;
+	float scaleAmount;
+
+	//shear example
+	GameEntity* shearingExample;
+	int shearDir;
+	float shearAmount;
+
+	//LERP example
+	GameEntity* lerpExample;
+	glm::vec3 lerpStart;
+	glm::vec3 lerpEnd;
+	float lerpTime;
+	float lerpStep;
+	bool lerpDirForward;
+
+	//SLERP example
+	GameEntity* slerpExample;
+	glm::vec3 slerpStart;
+	glm::vec3 slerpEnd;
+	float slerpTime;
+	float slerpStep;
+	bool slerpDirForward;
+
+	//gravity example
+	GameEntity* gravityExample;
+
+	void CreateBezierExample();
+	void SetupLERPExample();
+	void SetupSLERPExample();
+	void CreatePhysicsExample1();
+
+	void UpdateBezierExample();
+	void UpdateScaleExample();
+	void UpdateSheerExample();
+	void UpdateLERPExample();
+	void UpdateSLERPExample();
+	void UpdateGravityExample();
+
+	float RandomRange(float min, float max);
+
+public:
+	/// <summary>
+	/// Creates every example's entities in the world
+	/// </summary>
+	/// <param name="world">World the entities' bodies go in (not owned, has to outlive the scene)</param>
+	/// <param name="seed">Seed for the random forces in the linear momentum example, record it to get the same run again</param>
+	/// <param name="forceScale">Multiplies the random forces, for trying out variations of the scene</param>
+	ExampleScene(PhysicsWorld* world, unsigned int seed, float forceScale = 1.f);
+
+	/// <summary>
+	/// Destroys the entities (and their bodies)
+	/// </summary>
+	~ExampleScene();
+
+	/// <summary>
+	/// Moves every example along by one physics step, call it right after PhysicsWorld::Step
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// Updates every entity's world matrix (only needed when something draws them)
+	/// </summary>
+	/// <param name="interpolation">How far to blend from the previous physics step to the latest one (0 to 1)</param>
+	void UpdateEntities(float interpolation);
+
+	const std::vector<GameEntity*>& GetEntities() const { return entities; }
+
+	/// <summary>
+	/// The cube that falls and bounces in the gravity example, its collisions are reported
+	/// </summary>
+	GameEntity* GetGravityExample() const { return gravityExample; }
+
+	unsigned int GetSeed() const { return seed; }
+};
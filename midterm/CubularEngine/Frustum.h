@@ -0,0 +1,59 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "AABB.h"
+
+/// <summary>
+/// The 6 planes of a camera's view volume, each stored as (normal, distance) with the normal pointing inwards
+/// </summary>
+struct Frustum
+{
+	glm::vec4 planes[6];  //left, right, bottom, top, near, far
+
+	/// <summary>
+	/// Pulls the planes out of a projection * view matrix
+	/// </summary>
+	static Frustum FromMatrix(const glm::mat4& viewProjection)
+	{
+		//glm is column major, so row i is the i-th component of every column
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; i++)
+		{
+			rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		}
+
+		Frustum frustum;
+		frustum.planes[0] = rows[3] + rows[0];
+		frustum.planes[1] = rows[3] - rows[0];
+		frustum.planes[2] = rows[3] + rows[1];
+		frustum.planes[3] = rows[3] - rows[1];
+		frustum.planes[4] = rows[3] + rows[2];
+		frustum.planes[5] = rows[3] - rows[2];
+
+		for (int i = 0; i < 6; i++)
+		{
+			frustum.planes[i] /= glm::length(glm::vec3(frustum.planes[i]));
+		}
+		return frustum;
+	}
+
+	/// <summary>
+	/// False only if the box is completely outside of one of the planes
+	/// </summary>
+	bool Intersects(const AABB& bounds) const
+	{
+		glm::vec3 center = bounds.GetCenter();
+		glm::vec3 extents = bounds.GetExtents();
+
+		for (int i = 0; i < 6; i++)
+		{
+			glm::vec3 normal = glm::vec3(planes[i]);
+			float distance = glm::dot(normal, center) + planes[i].w;
+			float radius = glm::dot(glm::abs(normal), extents);
+			if (distance + radius < 0.f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
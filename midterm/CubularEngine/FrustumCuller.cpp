@@ -0,0 +1,31 @@
+#include "FrustumCuller.h"
+
+FrustumCuller::FrustumCuller()
+{
+	visibleCount = 0;
+	culledCount = 0;
+}
+
+void FrustumCuller::Begin()
+{
+	bounds.Clear();
+}
+
+int FrustumCuller::Add(const AABB& worldBounds)
+{
+	bounds.Add(worldBounds);
+	return bounds.GetCount() - 1;
+}
+
+int FrustumCuller::Cull(const Frustum& frustum)
+{
+	int count = bounds.GetCount();
+	if (visible.size() < count)
+	{
+		visible.resize(count);
+	}
+
+	visibleCount = CullFrustum(frustum, bounds, 0, count, visible.data());
+	culledCount = count - visibleCount;
+	return visibleCount;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "AABB.h"
+#include "Frustum.h"
+#include "SimdOverlap.h"
+
+/// <summary>
+/// Finds which of a frame's boxes a camera can see before anything is sent to the GPU.
+/// The boxes are kept as an AABBBatch and tested against the frustum 4 or 8 at a time (see CullFrustum),
+/// and the counts of the last Cull are kept for the stats
+/// </summary>
+class FrustumCuller
+{
+private:
+	AABBBatch bounds;
+	std::vector<unsigned int> visible;
+	int visibleCount;
+	int culledCount;
+
+public:
+	FrustumCuller();
+
+	/// <summary>
+	/// Empties the boxes for a new frame (keeps the memory)
+	/// </summary>
+	void Begin();
+
+	/// <summary>
+	/// Adds a world space box, returns its index for checking against GetVisible afterwards
+	/// </summary>
+	int Add(const AABB& worldBounds);
+
+	/// <summary>
+	/// Tests every box added since Begin against the frustum
+	/// </summary>
+	/// <returns>How many are at least partly inside</returns>
+	int Cull(const Frustum& frustum);
+
+	/// <summary>
+	/// Indices of the boxes the last Cull found visible, in the order they were added
+	/// </summary>
+	const unsigned int* GetVisible() const { return visible.data(); }
+
+	int GetVisibleCount() const { return visibleCount; }
+	int GetCulledCount() const { return culledCount; }
+};
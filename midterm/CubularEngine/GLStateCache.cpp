@@ -0,0 +1,100 @@
+#include "GLStateCache.h"
+
+GLStateCache* GLStateCache::instance = nullptr;
+
+GLStateCache::GLStateCache()
+{
+	//what a fresh context starts with
+	program = 0;
+	vertexArray = 0;
+	blending = false;
+
+	frame = RenderStats();
+	lastFrame = RenderStats();
+}
+
+GLStateCache::~GLStateCache()
+{
+}
+
+GLStateCache* GLStateCache::GetInstance()
+{
+	if (instance == nullptr)
+	{
+		instance = new GLStateCache();
+	}
+	return instance;
+}
+
+void GLStateCache::Release()
+{
+	delete instance;
+	instance = nullptr;
+}
+
+void GLStateCache::UseProgram(GLuint program)
+{
+	if (program == this->program)
+	{
+		frame.skippedChanges++;
+		return;
+	}
+	glUseProgram(program);
+	this->program = program;
+	frame.programChanges++;
+}
+
+void GLStateCache::BindVertexArray(GLuint vertexArray)
+{
+	if (vertexArray == this->vertexArray)
+	{
+		frame.skippedChanges++;
+		return;
+	}
+	glBindVertexArray(vertexArray);
+	this->vertexArray = vertexArray;
+	frame.vertexArrayChanges++;
+}
+
+void GLStateCache::SetBlending(bool enabled)
+{
+	if (enabled == blending)
+	{
+		frame.skippedChanges++;
+		return;
+	}
+
+	if (enabled)
+	{
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glDepthMask(GL_FALSE);
+	}
+	else
+	{
+		glDisable(GL_BLEND);
+		glDepthMask(GL_TRUE);
+	}
+	blending = enabled;
+	frame.blendChanges++;
+}
+
+void GLStateCache::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* offset)
+{
+	glDrawElements(mode, count, type, offset);
+	frame.drawCalls++;
+	frame.instances++;
+}
+
+void GLStateCache::DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* offset, GLsizei instanceCount)
+{
+	glDrawElementsInstanced(mode, count, type, offset, instanceCount);
+	frame.drawCalls++;
+	frame.instances += instanceCount;
+}
+
+void GLStateCache::BeginFrame()
+{
+	lastFrame = frame;
+	frame = RenderStats();
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "stdafx.h"
+
+/// <summary>
+/// What the renderer asked GL to do over one frame
+/// </summary>
+struct RenderStats
+{
+	int drawCalls;
+	int instances;          //copies drawn, an instanced draw counts all of its instances
+	int programChanges;     //glUseProgram calls that got through
+	int vertexArrayChanges; //glBindVertexArray calls that got through
+	int blendChanges;
+	int skippedChanges;     //binds of what was already bound, that never reached GL
+};
+
+/// <summary>
+/// Singleton every bind and draw goes through, so it knows what GL has bound and can drop
+/// binds that wouldn't change anything. Anything that binds programs or vertex arrays
+/// without it leaves it out of date, so everything has to go through here.
+/// Counts what it lets through each frame
+/// </summary>
+class GLStateCache
+{
+private:
+	/// <summary>
+	/// Singleton implementation (private constructor & destructor)
+	/// </summary>
+	GLStateCache();
+	~GLStateCache();
+
+	static GLStateCache* instance;
+
+	GLuint program;
+	GLuint vertexArray;
+	bool blending;
+
+	RenderStats frame;      //counting up
+	RenderStats lastFrame;  //finished
+
+public:
+	/// <summary>
+	/// Singleton reference to the instance
+	/// </summary>
+	static GLStateCache* GetInstance();
+
+	/// <summary>
+	/// De-allocation
+	/// </summary>
+	static void Release();
+
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vertexArray);
+
+	/// <summary>
+	/// Alpha blending for see through things, depth writes go off with it so they don't hide what's behind them
+	/// </summary>
+	void SetBlending(bool enabled);
+
+	void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* offset);
+	void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* offset, GLsizei instanceCount);
+
+	/// <summary>
+	/// Finishes counting the last frame and starts on the next, call it once a frame before drawing
+	/// </summary>
+	void BeginFrame();
+
+	/// <summary>
+	/// Counts for the last frame BeginFrame finished
+	/// </summary>
+	const RenderStats& GetLastFrameStats() const { return lastFrame; }
+};
@@ -8,8 +8,7 @@
 #include "glm/gtx/transform2.hpp"
 
 GameEntity::GameEntity(
-	Mesh * mesh, 
-    Material * material,
+	PhysicsWorld* world,
     glm::vec3 position, 
     glm::vec3 eulerAngles, 
     glm::vec3 scale,
@@ -20,44 +19,29 @@ GameEntity::GameEntity(
 	std::string tag,
 	glm::vec3 shear)
 {
-    this->mesh = mesh;
-    this->material = material;
-    this->position = position;
     this->eulerAngles = eulerAngles;
     this->scale = scale;
 	this->color = color;
     worldMatrix = glm::identity<glm::mat4>();
 
-	this->applyPhysics = applyPhysics;
-	this->collider = collider;
-	this->applyGravity = true;
-	this->weight = weight;
-	this->velocity = glm::vec3(0, 0, 0);
-	this->tag = tag;
+	this->world = world;
+	this->tag = TagRegistry::GetInstance()->Intern(tag);
+	this->body = world->CreateBody(position, collider, weight, applyPhysics, this->tag);
 	this->alpha = 1.f;
 	this->shear = shear;
 }
 
 GameEntity::~GameEntity()
 {
+	world->DestroyBody(body);
 }
 
-//Handles the physics of onjects in the world
-void GameEntity::Update(std::vector<GameEntity*> entities, int num, irrklang::ISoundEngine* engine)
+//Rebuilds the world matrix, the physics world has already moved the body.
+//Physics runs at its own rate, so draw the body part way between its last two steps
+void GameEntity::Update(float interpolation)
 {
-
-	if (this->applyPhysics)
-	{
-		this->UpdatePhysics();
-		this->CheckCollisions(entities, num, engine);
-		this->UpdatePosition();
-	}
-	else {
-		this->velocity = glm::vec3(0, 0, 0);
-	}
-
 	worldMatrix = glm::translate(glm::identity<glm::mat4>(),
-		this->position);
+		world->GetInterpolatedPosition(body, interpolation));
 
 	//Controls shear amount
 	worldMatrix = glm::shearX3D(worldMatrix, this->shear.y, this->shear.z);
@@ -85,193 +69,9 @@ void GameEntity::Update(std::vector<GameEntity*> entities, int num, irrklang::IS
 
 	
 
-}
-
-void GameEntity::UpdatePhysics()
-{
-	//apply physics calculations
-
-	//apply graivty
-	if (applyGravity)
-	{
-		this->velocity.y -= .0098;
-	}
-
-	//check collisions
-}
-
-
-//Checks for collisions with objects in the given vector
-void GameEntity::CheckCollisions(std::vector<GameEntity*> entities, int num, irrklang::ISoundEngine* engine)
-{
-	for (int i = 0; i < entities.size(); i++)
-	{
-		if (entities[i] != this)
-		{
-			//AABB collisions
-			if ((this->position.x + this->collider.x <= (entities[i]->position.x + entities[i]->collider.x) && this->position.x + this->collider.x >= (entities[i]->position.x - entities[i]->collider.x) ||
-				this->position.x - this->collider.x <= (entities[i]->position.x + entities[i]->collider.x) && this->position.x - this->collider.x >= (entities[i]->position.x - entities[i]->collider.x))
-				&&
-				(this->position.y + this->collider.y <= (entities[i]->position.y + entities[i]->collider.y) && this->position.y + this->collider.y >= (entities[i]->position.y - entities[i]->collider.y) ||
-					this->position.y - this->collider.y <= (entities[i]->position.y + entities[i]->collider.y) && this->position.y - this->collider.y >= (entities[i]->position.y - entities[i]->collider.y))
-				&&
-				(this->position.z + this->collider.z <= (entities[i]->position.z + entities[i]->collider.z) && this->position.z + this->collider.z >= (entities[i]->position.z - entities[i]->collider.z) ||
-					this->position.z - this->collider.z <= (entities[i]->position.z + entities[i]->collider.z) && this->position.z - this->collider.z >= (entities[i]->position.z - entities[i]->collider.z)))
-			{
-				
-				if (entities[i]->tag == std::string("Floor")) {
-					entities[i]->velocity = glm::vec3(0.f, 0.f, 0.f);
-					entities[i]->weight = this->weight;
-				}
-
-				//If the gravity exapmle play a sound
-				if (this->tag == std::string("SoundCube")) {
-					engine->play2D("../libraries/irrKlang-1.5.0/media/bounce.wav", false);
-				}
-
-				//glm::vec3 positionDiff = (entities[i]->position - this->position) - (entities[i]->position - (this->position + this->velocity));
-				//Checks for the future positions of the objects
-				glm::vec3 positionDiff = ((entities[i]->position + entities[i]->velocity) - (this->position + this->velocity));
-
-				if (entities[i]->tag == std::string("Wall")) {
-					entities[i]->velocity = this->velocity * -1.0f;
-				}
-				
-				//Detects collision on the x-axis
-				if (entities[i]->tag != std::string("Floor")) {
-					//if (positionDiff.x != 0 && abs(positionDiff.x) > abs(positionDiff.y) && abs(positionDiff.x) > abs(positionDiff.z))
-					if (positionDiff.x != 0)
-					{
-						if (positionDiff.x < 0 && this->velocity.x < 0)
-						{
-							float overshot = (this->position.x - this->collider.x) - (entities[i]->position.x + entities[i]->collider.x);
-							this->position.x -= overshot;
-
-							if (entities[i]->tag == std::string("Wall")) {
-								this->velocity.x = this->velocity.x * -1.0f;
-							}
-							else{
-								float thisVel = UpdateLinearMomentum(this->velocity.x, this->weight, entities[i]->velocity.x, entities[i]->weight);
-								float entityVel = UpdateLinearMomentum(entities[i]->velocity.x, entities[i]->weight, this->velocity.x, this->weight);
-								this->velocity.x = thisVel;
-								entities[i]->velocity.x = entityVel;
-							}
-						}
-						else if (positionDiff.x > 0 && this->velocity.x > 0)
-						{
-							float overshot = (this->position.x + this->collider.x) - (entities[i]->position.x - entities[i]->collider.x);
-							this->position.x -= overshot;
-
-							if (entities[i]->tag == std::string("Wall")) {
-								this->velocity.x = this->velocity.x * -1.0f;
-							}
-							else{
-								float thisVel = UpdateLinearMomentum(this->velocity.x, this->weight, entities[i]->velocity.x, entities[i]->weight);
-								float entityVel = UpdateLinearMomentum(entities[i]->velocity.x, entities[i]->weight, this->velocity.x, this->weight);
-								this->velocity.x = thisVel;
-								entities[i]->velocity.x = entityVel;
-							}
-						}
-					}
-				}
-
-				//Detects collision on the z-axis
-				if (entities[i]->tag != std::string("Floor")) {
-					//if (positionDiff.z != 0 && abs(positionDiff.z) > abs(positionDiff.x) && abs(positionDiff.z) > abs(positionDiff.x))
-					if (positionDiff.z != 0)
-					{
-						if (positionDiff.z < 0 && this->velocity.z < 0)
-						{
-							float overshot = (this->position.z - this->collider.z) - (entities[i]->position.z + entities[i]->collider.z);
-							this->position.z -= overshot;
-
-							if (entities[i]->tag == std::string("Wall")) {
-								this->velocity.z = this->velocity.z * -1.0f;
-							}
-							else{
-								float thisVel = UpdateLinearMomentum(this->velocity.z, this->weight, entities[i]->velocity.z, entities[i]->weight);
-								float entityVel = UpdateLinearMomentum(entities[i]->velocity.z, entities[i]->weight, this->velocity.z, this->weight);
-								this->velocity.z = thisVel;
-								entities[i]->velocity.z = entityVel;
-							}
-						}
-						else if (positionDiff.z > 0 && this->velocity.z > 0)
-						{
-							float overshot = (this->position.z + this->collider.z) - (entities[i]->position.z - entities[i]->collider.z);
-							this->position.z -= overshot;
-
-							if (entities[i]->tag == std::string("Wall")) {
-								this->velocity.z = this->velocity.z * -1.0f;
-							}
-							else{
-								float thisVel = UpdateLinearMomentum(this->velocity.z, this->weight, entities[i]->velocity.z, entities[i]->weight);
-								float entityVel = UpdateLinearMomentum(entities[i]->velocity.z, entities[i]->weight, this->velocity.z, this->weight);
-								this->velocity.z = thisVel;
-								entities[i]->velocity.z = entityVel;
-							}
-						}
-					}
-				}
-
-				//Detects collision on the x-axis
-				//if ((positionDiff.y != 0 && abs(positionDiff.y) > abs(positionDiff.x) && abs(positionDiff.y) > abs(positionDiff.z)) || entities[i]->tag == std::string("Floor"))
-				if ((positionDiff.y != 0) || entities[i]->tag == std::string("Floor"))
-				{
-					if (positionDiff.y < 0 && this->velocity.y < 0)
-					{
-						float overshot = (this->position.y - this->collider.y) - (entities[i]->position.y + entities[i]->collider.y);
-						this->position.y -= overshot;
-						
-						//mass dependent
-						float thisVel = UpdateLinearMomentum(this->velocity.y, this->weight, entities[i]->velocity.y, entities[i]->weight);
-						float entityVel = UpdateLinearMomentum(entities[i]->velocity.y, entities[i]->weight, this->velocity.y, this->weight);
-						this->velocity.y = thisVel;
-						entities[i]->velocity.y = entityVel;
-
-						//mass independent
-						/*float vel = this->velocity.y;
-						this->velocity.y = entities[i]->velocity.y;
-						entities[i]->velocity.y = vel;*/
-					}
-					else if (positionDiff.y > 0 && this->velocity.y > 0)
-					{
-						float overshot = (this->position.y + this->collider.y) - (entities[i]->position.y - entities[i]->collider.y);
-						this->position.y -= overshot;
-						
-						float thisVel = UpdateLinearMomentum(this->velocity.y, this->weight, entities[i]->velocity.y, entities[i]->weight);
-						float entityVel = UpdateLinearMomentum(entities[i]->velocity.y, entities[i]->weight, this->velocity.y, this->weight);
-						this->velocity.y = thisVel;
-						entities[i]->velocity.y = entityVel;
-					}
-				}
-			}
-		}
-	}
-}
-
-//Linear momentum equation returns the new velocity
-float GameEntity::UpdateLinearMomentum(float vel1, float mass1, float vel2, float mass2) {
-	float numerator = (mass1 - mass2)*vel1 + (2 * mass2*vel2);
-	float denominator = mass1 + mass2;
-	//std::cout << "Numerator: " << numerator<< std::endl;
-	//std::cout << "Denominator: " << denominator << std::endl;
-	return numerator / denominator;
-}
-
-void GameEntity::UpdatePosition()
-{
-	//apply to position
-	this->position += this->velocity;
-
 }
 
 void GameEntity::ApplyForce(glm::vec3 force)
 {
-	this->velocity += force;
+	world->ApplyForce(body, force);
 }
-
-void GameEntity::Render(Camera* camera)
-{
-    material->Bind(camera, worldMatrix, color, alpha);
-    mesh->Render();
-}
\ No newline at end of file
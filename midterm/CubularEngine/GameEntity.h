@@ -1,28 +1,21 @@
 #pragma once
-#include "stdafx.h"
-#include "Mesh.h"
-#include "Material.h"
-#include "Camera.h"
+#include <string>
+#include <glm/glm.hpp>
+#include "PhysicsWorld.h"
 
 /// <summary>
-/// Represents one 'renderable' objet
+/// Represents one objet in the scene. Only holds what the simulation needs (no GL state),
+/// whoever draws the scene reads the world matrix, color and alpha off it
 /// </summary>
 class GameEntity
 {
 private:
-    Mesh* mesh;        
-    Material* material;
-
     //TODO - maybe this should be in a transform class?
     glm::mat4 worldMatrix;
 
-	glm::vec3 velocity;
-	glm::vec3 collider;
-
-	void UpdatePhysics();
-	void CheckCollisions(std::vector<GameEntity*>, int num, irrklang::ISoundEngine* engine);
-	float UpdateLinearMomentum(float vel1, float mass1, float vel2, float mass2);
-	void UpdatePosition();
+	//the physics state (position, velocity, collider...) lives in the world
+	PhysicsWorld* world;
+	unsigned int body;
 
 
 public: 
@@ -30,8 +23,7 @@ public:
     /// Basic paramterized constructor for most of our private vars
     /// </summary>
     GameEntity(
-        Mesh* mesh,
-        Material* material,
+		PhysicsWorld* world,
         glm::vec3 position,
         glm::vec3 eulerAngles,
         glm::vec3 scale,
@@ -43,15 +35,11 @@ public:
 		glm::vec3 shear
     );
 
-	glm::vec3 position;
 	glm::vec3 eulerAngles;
 	glm::vec3 scale;
 	glm::vec3 color;
-	bool applyPhysics;
-	bool applyGravity;
-	float weight;
 	float alpha;
-	std::string tag;
+	TagId tag;
 	glm::vec3 shear;
     /// <summary>
     /// Destruction
@@ -59,15 +47,35 @@ public:
     virtual ~GameEntity();
 
     /// <summary>
-    /// Updates the worldMatrix
+    /// Model to world matrix as of the last Update
     /// </summary>
+    const glm::mat4& GetWorldMatrix() const { return worldMatrix; }
 
-    /// <summary>
-    /// Renders the gameEntity based on a camera
-    /// </summary>
-    void Render(Camera* camera);
+	/// <summary>
+	/// Updates the worldMatrix from the body's position (physics is done by the world)
+	/// </summary>
+	/// <param name="interpolation">How far to blend from the previous physics step to the latest one (0 to 1)</param>
+	virtual void Update(float interpolation);
+
+	/// <summary>
+	/// Gets the position from the physics world
+	/// </summary>
+	glm::vec3 GetPosition() const { return world->GetPosition(body); }
+
+	/// <summary>
+	/// Moves the body directly
+	/// </summary>
+	void SetPosition(glm::vec3 position) { world->SetPosition(body, position); }
+
+	/// <summary>
+	/// Handle to this entity's body in the physics world
+	/// </summary>
+	unsigned int GetBody() const { return body; }
 
-	virtual void Update(std::vector<GameEntity*>, int num, irrklang::ISoundEngine* engine);
+	/// <summary>
+	/// Gets the collider as a world space box
+	/// </summary>
+	AABB GetBounds() const { return AABB::FromCenter(world->GetPosition(body), world->GetCollider(body)); }
 
 	void ApplyForce(glm::vec3 force);
 
@@ -0,0 +1,94 @@
+#include "InstanceBatcher.h"
+
+InstanceBatcher::InstanceBatcher()
+{
+	glGenBuffers(1, &instanceBuffer);
+	bufferCapacity = 0;
+
+	drawCalls = 0;
+	instanceCount = 0;
+}
+
+InstanceBatcher::~InstanceBatcher()
+{
+	glDeleteBuffers(1, &instanceBuffer);
+}
+
+void InstanceBatcher::Add(Mesh* mesh, Material* material, const glm::mat4& worldMatrix, glm::vec3 color, float alpha)
+{
+	//there are only ever a handful of pairs, so looking through them is quicker than a map
+	Batch* batch = nullptr;
+	for (int i = 0; i < batches.size(); i++)
+	{
+		if (batches[i].mesh == mesh && batches[i].material == material)
+		{
+			batch = &batches[i];
+			break;
+		}
+	}
+	if (batch == nullptr)
+	{
+		batches.push_back(Batch());
+		batch = &batches.back();
+		batch->mesh = mesh;
+		batch->material = material;
+	}
+
+	MeshInstance instance;
+	instance.world = worldMatrix;
+	instance.color = glm::vec4(color, alpha);
+	batch->instances.push_back(instance);
+}
+
+void InstanceBatcher::Draw()
+{
+	drawCalls = 0;
+	instanceCount = 0;
+
+	for (int i = 0; i < batches.size(); i++)
+	{
+		Batch& batch = batches[i];
+		GLsizei count = (GLsizei)batch.instances.size();
+		if (count == 0)
+		{
+			continue;
+		}
+		instanceCount += count;
+
+		//no instanced program, fall back to a draw each
+		if (!batch.material->CanInstance())
+		{
+			for (int k = 0; k < count; k++)
+			{
+				const MeshInstance& instance = batch.instances[k];
+				batch.material->Bind(instance.world, glm::vec3(instance.color), instance.color.a);
+				batch.mesh->Render();
+				drawCalls++;
+			}
+			batch.instances.clear();
+			continue;
+		}
+
+		//orphan the old contents and grow if needed, then upload this batch's instances to the start
+		GLsizeiptr bytes = count * sizeof(MeshInstance);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+		if (bytes > bufferCapacity)
+		{
+			bufferCapacity = bytes * 2;
+		}
+		glBufferData(GL_ARRAY_BUFFER, bufferCapacity, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, batch.instances.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		if (!batch.mesh->IsInstancing(instanceBuffer))
+		{
+			batch.mesh->EnableInstancing(instanceBuffer);
+		}
+
+		batch.material->BindInstanced();
+		batch.mesh->RenderInstanced(count);
+		drawCalls++;
+
+		batch.instances.clear();
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include "stdafx.h"
+#include "Mesh.h"
+#include "Material.h"
+
+/// <summary>
+/// Collects everything to draw in a frame and draws each (mesh, material) pair with a single instanced
+/// draw call, instead of a bind and a draw per entity. The instances of one pair are uploaded to a
+/// shared instance buffer right before they're drawn (the buffer is orphaned each time, so the driver
+/// doesn't have to wait on the last draw). Pairs whose material has no instanced program are drawn one at a time
+/// </summary>
+class InstanceBatcher
+{
+private:
+	struct Batch
+	{
+		Mesh* mesh;
+		Material* material;
+		std::vector<MeshInstance> instances;
+	};
+
+	//kept between frames (just emptied) so adding doesn't allocate once the frame sizes settle
+	std::vector<Batch> batches;
+
+	GLuint instanceBuffer;
+	GLsizeiptr bufferCapacity;     //in bytes
+
+	int drawCalls;
+	int instanceCount;
+
+public:
+	/// <summary>
+	/// Creates the instance buffer, needs a GL context
+	/// </summary>
+	InstanceBatcher();
+
+	/// <summary>
+	/// Deletes the instance buffer
+	/// </summary>
+	~InstanceBatcher();
+
+	/// <summary>
+	/// Queues a copy of the mesh for the next Draw
+	/// </summary>
+	/// <param name="worldMatrix">Matrix from model to world space</param>
+	void Add(Mesh* mesh, Material* material, const glm::mat4& worldMatrix, glm::vec3 color, float alpha);
+
+	/// <summary>
+	/// Draws everything added since the last Draw, one draw call per (mesh, material), then empties the batches.
+	/// Draws with whatever camera is in the CameraUniforms buffer
+	/// </summary>
+	void Draw();
+
+	/// <summary>
+	/// Draw calls the last Draw made
+	/// </summary>
+	int GetDrawCallCount() const { return drawCalls; }
+
+	/// <summary>
+	/// Copies the last Draw drew
+	/// </summary>
+	int GetInstanceCount() const { return instanceCount; }
+};
@@ -1,5 +1,5 @@
 #pragma once
-#include "stdafx.h"
+#include <glm/glm.hpp>
 
 class Interpolate
 {
@@ -5,66 +5,78 @@
 #include "GameEntity.h"
 #include "Material.h"
 #include "Input.h"
-#include "BezierCurve.h"
-#include "Interpolate.h"
+#include "World.h"
+#include "Replay.h"
+#include "SoundPool.h"
+#include "SimulationLod.h"
+#include "InstanceBatcher.h"
+#include "CameraUniforms.h"
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+#include "FrustumCuller.h"
+#include <sstream>
+#include <cstring>
 
 
 //methods
-void CreateBezierExample(Mesh*, Material*, BezierCurve*);
-void UpdateBezierExample(BezierCurve *, GameEntity *);
-void UpdateScaleExample(GameEntity *);
-void UpdateSheerExample(GameEntity *);
-void UpdateLERPExample(GameEntity *);
-void UpdateSLERPExample(GameEntity *);
-void SetupLERPExample(Mesh *, Material *);
-void SetupSLERPExample(Mesh *, Material *);
+GLuint CreateShaderProgram(const char* vertexPath, const char* fragmentPath);
 Camera* CreateCamera(glm::vec3 pos, glm::vec3 forward, glm::vec3 up, int width, int height, GLFWwindow *window, bool controllable);
-void CreatePhysicsExample1(Mesh *mesh, Material *mat);
 void CheckUpdateCameras();
-void UpdateGravityExample(GameEntity* gameObj);
-void QuadTree(std::vector<GameEntity*> quadify, GameEntity* floor, glm::vec3 center, irrklang::ISoundEngine* sound);
+void PlayCollisionSounds(double time);
+void CheckToggleLod();
+void ShowRenderStats(GLFWwindow* window, double time, const FrustumCuller* culler);
 
-std::vector<GameEntity*> gameEntities;
-std::vector<GameEntity*> staticEntities;
-std::vector<GameEntity*> octreeEntities;
+//which broadphase the linear momentum example uses
+BroadphaseType broadphaseType = BroadphaseType::SweepAndPrune;
 
+//worker threads for anything that runs in parallel (uses every core)
+ThreadPool* threadPool = nullptr;
 
-//bezier cube example vars
-float bezierCubeTime = 0;
-float bezierCubeStep = 1.f / 500.f;
-bool bezierDirForward = true;
+//every example and the physics world they live in
+World* world = nullptr;
 
-//scaling example
-int scalingDir = 0;
-float scaleAmount = 1.f;
+//bodies far from (or behind) the active camera are stepped less often, L turns it on and off
+SimulationLod* simulationLod = nullptr;
+bool lodToggle = false;
 
-//shear example
-int shearDir = 0;
-float shearAmount = 0.f;
+//run with --record [file] to record every step, so a slow one can be replayed later with CubularHeadless --replay
+//(off by default, the file is written as it goes and grows for as long as the window stays open)
+const char* replayPath = "lastRun.cubr";
+ReplayRecorder* recorder = nullptr;
+bool recordRun = false;
 
-//interpolation declaration
-Interpolate interpolate;
+//collisions are queued up by the physics threads and turned into sounds once a frame
+EventQueue<CollisionEvent>* collisionQueue = nullptr;
+SoundPool* soundPool = nullptr;
+int bounceSound = -1;
 
-//LERP example
-glm::vec3 lerpStart = glm::vec3(50.f, 10.f, 5.f);
-glm::vec3 lerpEnd = glm::vec3(60.f, 5.f, 10.f);
-float lerpTime = 0;
-float lerpStep = 1.f / 100.f;
-bool lerpDirForward = true;
+//physics (and the examples) run at a fixed rate no matter how fast we render,
+//rendering blends between the last two steps
+const double physicsTimeStep = 1.0 / 60.0;
+const int maxPhysicsStepsPerFrame = 8;  //after a long hitch, drop the time instead of trying to catch up
 
-//SLERP example
-glm::vec3 slerpStart = glm::vec3(0.f, 0.f, 0.f);
-glm::vec3 slerpEnd = glm::vec3(0.f, 0.15f, 0.15f);
-float slerpTime = 0;
-float slerpStep = 1.f / 100.f;
-bool slerpDirForward = true;
+//what the renderer did last frame goes in the title bar, once a second so it can be read
+const char* windowTitle = "Justin & Jeb - Final Project: Physics Scene";
+const double renderStatsInterval = 1.0;
+double lastRenderStatsTime = 0.0;
 
 std::vector<Camera*> cameras;
 int curCamera = 0;
 bool cameraSwap = false;
 
-int main()
+int main(int argc, char** argv)
 {
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--record") == 0)
+		{
+			recordRun = true;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				replayPath = argv[++i];
+			}
+		}
+	}
 
 	irrklang::ISoundEngine* engine = irrklang::createIrrKlangDevice();
 
@@ -72,6 +84,11 @@ int main()
 
 	engine->play2D("../libraries/irrKlang-1.5.0/media/LastTrainHome.mp3", true);
 
+	//at most 16 effects at once, and a bounce can't start more than 20 times a second
+	soundPool = new SoundPool(engine, 16);
+	bounceSound = soundPool->AddEffect("../libraries/irrKlang-1.5.0/media/bounce.wav", 0.05, 4);
+	collisionQueue = new EventQueue<CollisionEvent>(1024);
+
     {
         //init GLFW
         {
@@ -92,7 +109,7 @@ int main()
         //create & init window, set viewport
         int width = 1200;
         int height = 800;
-        GLFWwindow* window = glfwCreateWindow(width, height, "Justin & Jeb - Final Project: Physics Scene", nullptr, nullptr);
+        GLFWwindow* window = glfwCreateWindow(width, height, windowTitle, nullptr, nullptr);
         {
             if (window == nullptr)
             {
@@ -135,47 +152,18 @@ int main()
         std::cout << "GLEW successfully initialized!" << std::endl;
 #endif // _DEBUG
 
-        //init the shader program
+        //init the shader programs, the instanced one draws every copy of a mesh at once
         //TODO - this seems like a better job for a shader manager
-        //       perhaps the Shader class can be refactored to fit a shader program
-        //       rather than be a thing for vs and fs
-        GLuint shaderProgram = glCreateProgram();
+        GLuint shaderProgram = CreateShaderProgram("../assets/shaders/vertexShader.glsl", "../assets/shaders/fragmentShader.glsl");
+        GLuint instancedProgram = CreateShaderProgram("../assets/shaders/vertexShaderInstanced.glsl", "../assets/shaders/fragmentShader.glsl");
+        if (shaderProgram == 0 || instancedProgram == 0)
         {
-
-            //create vS and attach to shader program
-            Shader *vs = new Shader();
-            vs->InitFromFile("../assets/shaders/vertexShader.glsl", GL_VERTEX_SHADER);
-            glAttachShader(shaderProgram, vs->GetShaderLoc());
-
-            //create FS and attach to shader program
-            Shader *fs = new Shader();
-            fs->InitFromFile("../assets/shaders/fragmentShader.glsl", GL_FRAGMENT_SHADER);
-            glAttachShader(shaderProgram, fs->GetShaderLoc());
-
-            //link everything that's attached together
-            glLinkProgram(shaderProgram);
-
-            GLint isLinked;
-            glGetProgramiv(shaderProgram, GL_LINK_STATUS, &isLinked);
-            if (!isLinked)
-            {
-                char infolog[1024];
-                glGetProgramInfoLog(shaderProgram, 1024, NULL, infolog);
 #ifdef _DEBUG
-                std::cout << "Shader Program linking failed with error: " << infolog << std::endl;
-                std::cin.get();
+            std::cin.get();
 #endif
-
-                // Delete the shader, and set the index to zero so that this object knows it doesn't have a shader.
-                glDeleteProgram(shaderProgram);
-                glfwTerminate();
-                _CrtDumpMemoryLeaks();
-                return 1;
-            }
-
-            //everything's in the program, we don't need this
-            delete fs;
-            delete vs;
+            glfwTerminate();
+            _CrtDumpMemoryLeaks();
+            return 1;
         }
 
 #ifdef _DEBUG
@@ -197,11 +185,12 @@ int main()
 		std::cout << "[4] LERP: This shows a basic LERP, of an object moving from one given point to another along a linear generated path (green and red points are start and end points)" << std::endl;
 		std::cout << "[5] SLERP: This example shows SLERP being used to 'animate' a cube rotating from a rest state to a turned state, and then back." << std::endl;
 		std::cout << "[6] Shear: This shows a simple shear of a cube, on every axis one after another" << std::endl;
-		std::cout << "[7] Linear Momentum: This example starts by randomly spawning 35 game entities with physics enabled (without friction on the surface below them) and applying a random force to each one, to showcase our collisions, and physics with linear momentum. We also take advantage of quadtree with this example, to cut back on the number of collision checks that are needed each update." << std::endl;
+		std::cout << "[7] Linear Momentum: This example starts by randomly spawning 35 game entities with physics enabled (without friction on the surface below them) and applying a random force to each one, to showcase our collisions, and physics with linear momentum. We also take advantage of " << GetBroadphaseName(broadphaseType) << " with this example, to cut back on the number of collision checks that are needed each update." << std::endl;
 		std::cout << "[8] Gravity Example: Another example showcasing physics and collisions, this time with an object falling with just gravity, and when hitting the ground, applying a force upwards again, until gravity makes it fall back down." << std::endl;
 		std::cout << "\n\n-Other Stuff-:" << std::endl;
 		std::cout << "Music is playing in the background on loop (song: Last Train Home by Pat Metheny Group)" << std::endl;
 		std::cout << "In the gravity example an explosion noise is played whenever a collision is detected" << std::endl;
+		std::cout << "Bodies far from the camera or out of view are simulated less often, press L to turn that on or off" << std::endl;
 
 
 		 //setting the input mode to remove the cursor from the screen, and lock the user into that window (use alt-tab to get out)
@@ -250,150 +239,37 @@ int main()
 
 
 
-		//==================== create bezier cubes==================================
-		Mesh* bMesh = new Mesh();
-		bMesh->InitWithVertexArray(vertices, _countof(vertices), shaderProgram);
-		Material* bMat = new Material(shaderProgram);
-
-
-		glm::vec2 curveStart = glm::vec2(20.f, 10.f);
-		BezierCurve* bezierCurve = new BezierCurve(curveStart, glm::vec2(10, 10), glm::vec2(5, 20), glm::vec2(25, 20));
-		CreateBezierExample(bMesh, bMat, bezierCurve);
-
-		GameEntity* bezierCube = new GameEntity(
-			bMesh,
-			bMat,
-			glm::vec3(curveStart.x, curveStart.y, 5),
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(0.4f, 0.4f, 0.4f),
-			glm::vec3(0.13f, 0.73f, 0.27f),
-			false,
-			glm::vec3(0.f, 0.f, 0.f),
-			0,
-			"Object",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-
-		staticEntities.push_back(bezierCube);
-
-		//============ create scaling example=============================
-		GameEntity* scaleExample = new GameEntity(
-			bMesh,
-			bMat,
-			glm::vec3(40, 5, 5),
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(1.f, 1.f, 1.f),
-			glm::vec3(0.8f, 0.8f, 0.8f),
-			false,
-			glm::vec3(0.f, 0.f, 0.f),
-			0,
-			"Object",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-
-		staticEntities.push_back(scaleExample);
-
-		//============ create shearing example=============================
-		GameEntity* shearingExample = new GameEntity(
-			bMesh,
-			bMat,
-			glm::vec3(90, 5, 5),
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(1.f, 1.f, 1.f),
-			glm::vec3(0.8f, 0.8f, 0.8f),
-			false,
-			glm::vec3(0.f, 0.f, 0.f),
-			0,
-			"Object",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-
-		staticEntities.push_back(shearingExample);
-
-		//================== create lerp example ========================
-
-		SetupLERPExample(bMesh, bMat);
-
-		//moving var
-		GameEntity* lerpExample = new GameEntity(
-			bMesh,
-			bMat,
-			lerpStart,
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(0.5f, 0.5f, 0.5f),
-			glm::vec3(0.8f, 0.8f, 0.8f),
-			false,
-			glm::vec3(0.f, 0.f, 0.f),
-			0,
-			"Object",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-
-		staticEntities.push_back(lerpExample);
-
-		//================== create slerp example ========================
-
-		SetupSLERPExample(bMesh, bMat);
-
-		//moving var
-		GameEntity* slerpExample = new GameEntity(
-			bMesh,
-			bMat,
-			glm::vec3(75.f, 6.f, 5.f),
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(2.f, 2.f, 2.f),
-			glm::vec3(0.8f, 0.8f, 0.8f),
-			false,
-			glm::vec3(0.f, 0.f, 0.f),
-			0,
-			"Object",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-
-		staticEntities.push_back(slerpExample);
-
-		//create floor 
-		Mesh* floorMesh = new Mesh();
-		floorMesh->InitWithVertexArray(vertices, _countof(vertices), shaderProgram);
-		Material* floorMat = new Material(shaderProgram);
-
-		GameEntity* floor = new GameEntity(
-			floorMesh,
-			floorMat,
-			glm::vec3(0.f, -10.f, 0.f),
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(100.f, 1.f, 100.f),
-			glm::vec3(0.2f, 0.2f, 0.2f),
-			false,
-			glm::vec3(100.f, 1.f, 100.f),
-			1,
-			"Floor",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-
-		gameEntities.push_back(floor);
-
-		//======================================= create no gravity linear momentum example =======================
-
-		CreatePhysicsExample1(floorMesh, floorMat);
+		//==================== create the world and its examples ==================================
+		threadPool = new ThreadPool(0);
+		unsigned int seed = (unsigned int)time(NULL);
+		world = new World(broadphaseType, seed, 1.f, threadPool);
+		world->GetPhysicsWorld()->SetEventQueue(collisionQueue);
+		recorder = recordRun ? new ReplayRecorder(replayPath, seed, (int)broadphaseType) : nullptr;
+		simulationLod = new SimulationLod(60.f, 150.f);
+		std::cout << "Scene seed is " << seed;
+		if (recorder != nullptr)
+		{
+			std::cout << ", recording to " << replayPath;
+		}
+		std::cout << std::endl;
+
+		//every entity is the same cube, just moved, scaled and colored differently
+		Mesh* cubeMesh = new Mesh();
+		cubeMesh->InitWithVertexArray(vertices, _countof(vertices), shaderProgram);
+		Material* cubeMat = new Material(shaderProgram, instancedProgram);
+
+		//everything drawn is sorted to keep state changes down, then entities sharing a mesh and material are drawn together
+		RenderQueue* renderQueue = new RenderQueue();
+		InstanceBatcher* batcher = new InstanceBatcher();
 
-		Input::GetInstance()->Init(window);
+		//only entities the active camera can see are submitted, the cube mesh spans -1 to 1 before its world matrix
+		FrustumCuller* culler = new FrustumCuller();
+		AABB cubeBounds = AABB(glm::vec3(-1.f), glm::vec3(1.f));
 
-		//============================================= create gravity example =================================
-		GameEntity* gravityExample = new GameEntity(
-			bMesh,
-			bMat,
-			glm::vec3(40.f, 50.f, -70.f),
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(2.f, 2.f, 2.f),
-			glm::vec3(0.8f, 0.8f, 0.8f),
-			true,
-			glm::vec3(2.f, 2.f, 2.f),
-			1,
-			"SoundCube",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-		gameEntities.push_back(gravityExample);
+		//every program reads the camera from here
+		CameraUniforms* cameraUniforms = new CameraUniforms();
+
+		Input::GetInstance()->Init(window);
 
 		//=====================================setup cameras==========================================
 		Camera* freeCam = CreateCamera(
@@ -481,10 +357,10 @@ int main()
         glEnable(GL_DEPTH_TEST);
         glDepthFunc(GL_LESS);
 
-
-		staticEntities.push_back(floor);
-		octreeEntities.push_back(floor);
         //--------------------================================start main loop========================----------------------------
+		double previousTime = glfwGetTime();
+		double accumulator = 0.0;
+
         while (!glfwWindowShouldClose(window))
         {
             /* INPUT */
@@ -502,45 +378,47 @@ int main()
 
             /* GAMEPLAY UPDATE */
 
-			for (int i = 0; i < gameEntities.size(); i++)
-			{
-				gameEntities[i]->Update(gameEntities, i, engine);
-			}
+			double currentTime = glfwGetTime();
+			accumulator += currentTime - previousTime;
+			previousTime = currentTime;
 
-			for (int i = 0; i < staticEntities.size(); i++)
+			//decide what gets stepped less often from the camera we're looking through
+			Camera* activeCamera = cameras[curCamera];
+			simulationLod->Update(world->GetPhysicsWorld(), activeCamera->GetPosition(), activeCamera->GetFrustum());
+
+			int physicsSteps = 0;
+			while (accumulator >= physicsTimeStep && physicsSteps < maxPhysicsStepsPerFrame)
 			{
-				staticEntities[i]->Update(staticEntities, i, engine);
+				//physics, then every example
+				double stepStart = glfwGetTime();
+				world->Step((float)physicsTimeStep);
+				double stepEnd = glfwGetTime();
+
+				if (recorder != nullptr)
+				{
+					recorder->RecordStep(world->GetPhysicsWorld(), (float)physicsTimeStep, (stepEnd - stepStart) * 1000.0);
+				}
+
+				accumulator -= physicsTimeStep;
+				physicsSteps++;
 			}
-
-			/*for (int i = 0; i < octreeEntities.size(); i++)
+			if (physicsSteps == maxPhysicsStepsPerFrame)
 			{
-				octreeEntities[i]->Update(octreeEntities, i, engine);
-			}*/
-
-			QuadTree(octreeEntities, floor, glm::vec3(0.f, -7.f, -70.f), engine);
-
-			cameras[curCamera]->Update();
-
-			//update bezier example
-			UpdateBezierExample(bezierCurve, bezierCube);
-
-			//update scaling example
-			UpdateScaleExample(scaleExample);
+				accumulator = 0.0;
+			}
 
-			//update shearing example
-			UpdateSheerExample(shearingExample);
+			PlayCollisionSounds(currentTime);
 
-			//update lerp example
-			UpdateLERPExample(lerpExample);
+			//how far we are between the last step and the next one
+			float interpolation = (float)(accumulator / physicsTimeStep);
 
-			//update slerp example
-			UpdateSLERPExample(slerpExample);
+			world->GetScene()->UpdateEntities(interpolation);
 
-			//update gravity example
-			UpdateGravityExample(gravityExample);
+			cameras[curCamera]->Update();
 
 			//update cameras
 			CheckUpdateCameras();
+			CheckToggleLod();
 
             /* PRE-RENDER */
             {
@@ -551,62 +429,68 @@ int main()
             }
 
             /* RENDER */
-			for (int i = 0; i < gameEntities.size(); i++)
-			{
-				gameEntities[i]->Render(cameras[curCamera]);
-			}
-			for (int i = 0; i < staticEntities.size(); i++)
+			GLStateCache::GetInstance()->BeginFrame();
+			ShowRenderStats(window, currentTime, culler);
+
+			const std::vector<GameEntity*>& entities = world->GetScene()->GetEntities();
+			culler->Begin();
+			for (int i = 0; i < entities.size(); i++)
 			{
-				staticEntities[i]->Render(cameras[curCamera]);
+				culler->Add(cubeBounds.Transform(entities[i]->GetWorldMatrix()));
 			}
-			for (int i = 0; i < octreeEntities.size(); i++)
+			int visibleCount = culler->Cull(cameras[curCamera]->GetFrustum());
+
+			renderQueue->Begin(cameras[curCamera]->GetView());
+			const unsigned int* visible = culler->GetVisible();
+			for (int i = 0; i < visibleCount; i++)
 			{
-				octreeEntities[i]->Render(cameras[curCamera]);
+				GameEntity* entity = entities[visible[i]];
+				renderQueue->Submit(entity, cubeMesh, cubeMat, entity->GetWorldMatrix(), entity->color, entity->alpha);
 			}
+			cameraUniforms->Update(cameras[curCamera]);
+			renderQueue->Draw(batcher);
 
 
             /* POST-RENDER */
             {
                 //'clear' for next draw call
-                glBindVertexArray(0);
-                glUseProgram(0);
+                GLStateCache::GetInstance()->BindVertexArray(0);
+                GLStateCache::GetInstance()->UseProgram(0);
                 //swaps the front buffer with the back buffer
                 glfwSwapBuffers(window);
             }
         }
 
 		//Delete Sound engine
+		delete soundPool;
 		engine->drop();
 
         //de-allocate our mesh!
 
-		delete floorMesh;
-		delete floorMat;
-
-		delete bMesh;
-		delete bMat;
+		delete culler;
+		delete renderQueue;
+		delete batcher;
+		delete cameraUniforms;
+		delete cubeMesh;
+		delete cubeMat;
+		glDeleteProgram(instancedProgram);
+		glDeleteProgram(shaderProgram);
 
-		delete bezierCurve;
+		delete recorder;
+		delete simulationLod;
 
-		for (int i = 0; i < gameEntities.size(); i++)
-		{
-			delete gameEntities[i];
-		}
-		for (int i = 0; i < staticEntities.size()-1; i++)
-		{
-			delete staticEntities[i];
-		}
+		delete world;
+		delete threadPool;
+		delete collisionQueue;
 
-		for (int i = 0; i < octreeEntities.size()-1; i++)
-		{
-			delete octreeEntities[i];
-		}
 		//cubeGraph.clear();
 		for (int i = 0; i < cameras.size(); i++)
 		{
 			delete cameras[i];
 		}
         Input::Release();
+		TagRegistry::Release();
+		GLStateCache::Release();
     }
 
     //clean up
@@ -617,237 +501,43 @@ int main()
     return 0;
 }
 
-// ========================================================== create bezier curve example
-void CreateBezierExample(Mesh* bMesh, Material* bMat, BezierCurve* bezierCurve)
+// ========================================================== compiles and links a vertex and fragment shader, 0 if it fails
+GLuint CreateShaderProgram(const char* vertexPath, const char* fragmentPath)
 {
-	int pointCount = 100;
-
-	float interval = (float)(1.f / pointCount);
-	//create line of objects to show the curve
-	for (int i = 0; i < pointCount; i++)
-	{
-		float t = interval * i;
-		glm::vec2 pos = bezierCurve->GetPoint(t);
-		GameEntity* myGameEntity = new GameEntity(
-			bMesh,
-			bMat,
-			glm::vec3(pos.x, pos.y, 5),
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(0.02f, 0.02f, 0.02f),
-			glm::vec3(0.8f, 0.8f, 0.8f),
-			false,
-			glm::vec3(0.f, 0.f, 0.f),
-			0,
-			"Object",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-		staticEntities.push_back(myGameEntity);
-	}
-
-	glm::vec2 pos = bezierCurve->GetPoint(0);
-	GameEntity* start = new GameEntity(
-		bMesh,
-		bMat,
-		glm::vec3(pos.x, pos.y, 5),
-		glm::vec3(0.f, 0.f, 0.f),
-		glm::vec3(0.1f, 0.1f, 0.1f),
-		glm::vec3(1.0f, 0.f, 0.0f),
-		false,
-		glm::vec3(0.f, 0.f, 0.f),
-		0,
-		"Object",
-		glm::vec3(0.f, 0.f, 0.f)
-	);
-
-	pos = bezierCurve->GetPoint(1);
-	GameEntity* end = new GameEntity(
-		bMesh,
-		bMat,
-		glm::vec3(pos.x, pos.y, 5),
-		glm::vec3(0.f, 0.f, 0.f),
-		glm::vec3(0.1f, 0.1f, 0.1f),
-		glm::vec3(0.0f, 1.f, 0.0f),
-		false,
-		glm::vec3(0.f, 0.f, 0.f),
-		0,
-		"Object",
-		glm::vec3(0.f, 0.f, 0.f)
-	);
-
-	staticEntities.push_back(start);
-	staticEntities.push_back(end);
-}
-
-// ========================================================== update bezier curve example
-void UpdateBezierExample(BezierCurve *bezierCurve, GameEntity *gameObj)
-{
-	bezierCubeTime += (bezierDirForward) ? bezierCubeStep : -bezierCubeStep;
-
-	if (bezierCubeTime >= 1.f) { bezierCubeTime = 1.f; bezierDirForward = false; }
-	else if (bezierCubeTime <= 0) { bezierCubeTime = 0.f; bezierDirForward = true; }
-
+	GLuint shaderProgram = glCreateProgram();
 
-	glm::vec2 newPos = bezierCurve->GetPoint(bezierCubeTime);
-
-	gameObj->position.x = newPos.x;
-	gameObj->position.y = newPos.y;
-	gameObj->position.z = 5;
-}
-
-// ========================================================== update Scale example
-void UpdateScaleExample(GameEntity *gameObj)
-{
-	glm::vec3 scaleSet = glm::vec3(1.f, 1.f, 1.f);
-	scaleAmount += (scalingDir % 2 == 0) ? 0.01f : -0.01f;
-
-	if (scaleAmount >= 2.f || scaleAmount <= 1.f)
-	{
-		scaleAmount = (scaleAmount >= 2.f) ? 2.f : 1.f;
-		scalingDir++;
-		if (scalingDir == 6) { scalingDir = 0; }
-	}
-
-	if (scalingDir == 0 || scalingDir == 1)
-	{
-		scaleSet.x = scaleAmount;
-	}
-	else if (scalingDir == 2 || scalingDir == 3)
-	{
-		scaleSet.y = scaleAmount;
-	}
-	else
-	{
-		scaleSet.z = scaleAmount;
-	}
-
-	//update to new scale and rotation
-	gameObj->scale = scaleSet;
-	gameObj->eulerAngles.y += 0.009f;
-	gameObj->eulerAngles.x += 0.006f;
-	gameObj->eulerAngles.z += 0.003f;
-}
-
-// ========================================================== update Sheer example
-void UpdateSheerExample(GameEntity *gameObj)
-{
-	glm::vec3 shearSet = glm::vec3(0.f, 0.f, 0.f);
-	shearAmount += (shearDir % 2 == 0) ? 0.01f : -0.01f;
-	if (shearAmount >= 1.f || shearAmount <= 0.f)
-	{
-		shearAmount = (shearAmount >= 1.f) ? 1.f : 0.f;
-		shearDir++;
-		if (shearDir == 6) { shearDir = 0; }
-	}
+	//create vS and attach to shader program
+	Shader* vs = new Shader();
+	vs->InitFromFile(vertexPath, GL_VERTEX_SHADER);
+	glAttachShader(shaderProgram, vs->GetShaderLoc());
 
-	if (shearDir == 0 || shearDir == 1)
-	{
-		shearSet.x = shearAmount;
-	}
-	else if (shearDir == 2 || shearDir == 3)
-	{
-		shearSet.y = shearAmount;
-	}
-	else
-	{
-		shearSet.z = shearAmount;
-	}
+	//create FS and attach to shader program
+	Shader* fs = new Shader();
+	fs->InitFromFile(fragmentPath, GL_FRAGMENT_SHADER);
+	glAttachShader(shaderProgram, fs->GetShaderLoc());
 
-	gameObj->shear = shearSet;
-}
+	//link everything that's attached together
+	glLinkProgram(shaderProgram);
 
-// ========================================================== create LERP example
-void SetupLERPExample(Mesh *bMesh, Material *bMat)
-{
-	int pointCount = 100;
-	float step = 1.f / pointCount;
+	//everything's in the program (or it failed), we don't need these
+	delete fs;
+	delete vs;
 
-	//create line of objects to show line of LERP
-	for (int i = 0; i < pointCount; i++)
+	GLint isLinked;
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &isLinked);
+	if (!isLinked)
 	{
-		float t = step * i;
-
-		GameEntity* obj = new GameEntity(
-			bMesh,
-			bMat,
-			interpolate.LERP(lerpStart, lerpEnd, t),
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(.02f, .02f, .02f),
-			glm::vec3(0.8f, 0.8f, 0.8f),
-			false,
-			glm::vec3(0.f, 0.f, 0.f),
-			0,
-			"Object",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-
-		staticEntities.push_back(obj);
-	}
-
-	//start / end pos
-	GameEntity* lerpStartObj = new GameEntity(
-		bMesh,
-		bMat,
-		lerpStart,
-		glm::vec3(0.f, 0.f, 0.f),
-		glm::vec3(.1f, .1f, .1f),
-		glm::vec3(1.0f, 0.0f, 0.0f),
-		false,
-		glm::vec3(0.f, 0.f, 0.f),
-		0,
-		"Object",
-		glm::vec3(0.f, 0.f, 0.f)
-	);
-	GameEntity* lerpEndObj = new GameEntity(
-		bMesh,
-		bMat,
-		lerpEnd,
-		glm::vec3(0.f, 0.f, 0.f),
-		glm::vec3(.1f, .1f, .1f),
-		glm::vec3(0.0f, 1.0f, 0.0f),
-		false,
-		glm::vec3(0.f, 0.f, 0.f),
-		0,
-		"Object",
-		glm::vec3(0.f, 0.f, 0.f)
-	);
-
-	staticEntities.push_back(lerpStartObj);
-	staticEntities.push_back(lerpEndObj);
-}
-
-// ========================================================== create SLERP example
-void SetupSLERPExample(Mesh *bMesh, Material *bMat)
-{
-	int pointCount = 100;
-	float step = 1.f / pointCount;
+		char infolog[1024];
+		glGetProgramInfoLog(shaderProgram, 1024, NULL, infolog);
+#ifdef _DEBUG
+		std::cout << "Shader Program " << vertexPath << " linking failed with error: " << infolog << std::endl;
+#endif
 
-	for (int i = 0; i < pointCount; i++)
-	{
-		float t = step * i;
-		glm::vec3 pos = interpolate.SLERP(slerpStart, slerpEnd, t);
+		// Delete the shader, and set the index to zero so that this object knows it doesn't have a shader.
+		glDeleteProgram(shaderProgram);
+		return 0;
 	}
-}
-
-// ========================================================== update LERP example
-void UpdateLERPExample(GameEntity *gameObj)
-{
-	lerpTime += (lerpDirForward) ? lerpStep : -lerpStep;
-	if (lerpTime >= 1.f || lerpTime <= 0.f) { lerpDirForward = !lerpDirForward; }
-
-	glm::vec3 pos = interpolate.LERP(lerpStart, lerpEnd, lerpTime);
-
-	gameObj->position = pos;
-}
-
-// ========================================================== update SLERP rotation example
-void UpdateSLERPExample(GameEntity *gameObj)
-{
-	slerpTime += (slerpDirForward) ? slerpStep : -slerpStep;
-	if (slerpTime >= 1.f || slerpTime <= 0.f) { slerpDirForward = !slerpDirForward; }
-
-	glm::vec3 angle = interpolate.SLERP(slerpStart, slerpEnd, slerpTime);
-
-	gameObj->eulerAngles = angle;
+	return shaderProgram;
 }
 
 // ========================================================== creates a camera based on given params
@@ -869,171 +559,15 @@ Camera* CreateCamera(glm::vec3 pos, glm::vec3 forward, glm::vec3 up, int width,
 	return camera;
 }
 
-// ========================================================== create linear momentum example 1 (box)
-void CreatePhysicsExample1(Mesh *mesh, Material *mat)
+//Plays a bounce for the collisions queued up since last frame (as many as the sound pool lets through)
+void PlayCollisionSounds(double time)
 {
-	GameEntity* wall1 = new GameEntity(
-		mesh,
-		mat,
-		glm::vec3(0.f, -7.f, -50.f),
-		glm::vec3(0.f, 0.f, 0.f),
-		glm::vec3(20.f, 2.f, 2.0f),
-		glm::vec3(0.4f, 0.4f, 0.4f),
-		false,
-		glm::vec3(20.f, 2.f, 2.f),
-		1,
-		"Wall",
-		glm::vec3(0.f, 0.f, 0.f)
-	);
-
-	GameEntity* wall2 = new GameEntity(
-		mesh,
-		mat,
-		glm::vec3(0.f, -7.f, -90.f),
-		glm::vec3(0.f, 0.f, 0.f),
-		glm::vec3(20.f, 2.f, 2.f),
-		glm::vec3(0.4f, 0.4f, 0.4f),
-		false,
-		glm::vec3(20.f, 2.f, 2.f),
-		1,
-		"Wall",
-		glm::vec3(0.f, 0.f, 0.f)
-	);
-
-	GameEntity* wall3 = new GameEntity(
-		mesh,
-		mat,
-		glm::vec3(-20.f, -7.f, -70.f),
-		glm::vec3(0.f, 0.f, 0.f),
-		glm::vec3(2.f, 2.f, 20.f),
-		glm::vec3(0.4f, 0.4f, 0.4f),
-		false,
-		glm::vec3(2.f, 2.f, 20.f),
-		1,
-		"Wall",
-		glm::vec3(0.f, 0.f, 0.f)
-	);
-
-	GameEntity* wall4 = new GameEntity(
-		mesh,
-		mat,
-		glm::vec3(20.f, -7.f, -70.f),
-		glm::vec3(0.f, 0.f, 0.f),
-		glm::vec3(2.f, 2.f, 20.f),
-		glm::vec3(0.4f, 0.4f, 0.4f),
-		false,
-		glm::vec3(2.f, 2.f, 20.f),
-		1,
-		"Wall",
-		glm::vec3(0.f, 0.f, 0.f)
-	);
-
-	//add 4 walls
-	octreeEntities.push_back(wall1);
-	octreeEntities.push_back(wall2);
-	octreeEntities.push_back(wall3);
-	octreeEntities.push_back(wall4);
-
-	//create a bunch of entities to move around (and apply random forces to each one)
-	int cubeCount = 35;
-	srand(time(NULL));
-
-	for (int i = 0; i < cubeCount; i++)
+	CollisionEvent event;
+	while (collisionQueue->Pop(event))
 	{
-		float randomZ = -85.f + (static_cast <float> (rand() / (static_cast <float> (RAND_MAX / (-55.f - (-85.f))))));
-		
-		glm::vec3 pos = glm::vec3((0.7f * i) + 1.f - 18.f, -6.f, randomZ);
-		GameEntity* cube = new GameEntity(
-			mesh,
-			mat,
-			pos,
-			glm::vec3(0.f, 0.f, 0.f),
-			glm::vec3(0.5f, 0.5f, 0.5f),
-			glm::vec3(0.7f, 0.7f, 0.7f),
-			true,
-			glm::vec3(0.5f, 0.5f, 0.5f),
-			1,
-			"Object",
-			glm::vec3(0.f, 0.f, 0.f)
-		);
-
-		float dirX = -0.5f + (static_cast <float> (rand() / (static_cast <float> (RAND_MAX / (0.5f - (-0.5f))))));
-		float dirZ = -0.5f + (static_cast <float> (rand() / (static_cast <float> (RAND_MAX / (0.5f - (-0.5f))))));
-
-		glm::vec3 randomForce = glm::vec3(dirX, 0.0f, 0.0f);
-
-		cube->ApplyForce(randomForce);
-
-		octreeEntities.push_back(cube);
-	}
-}
-
-//QuadTree creates as set of vectors each based on the regions generated
-void QuadTree(std::vector<GameEntity*> quadify, GameEntity* floor, glm::vec3 center, irrklang::ISoundEngine* sound) {
-
-	std::vector<GameEntity*> topRight;
-	std::vector<GameEntity*> bottomRight;
-	std::vector<GameEntity*> bottomLeft;
-	std::vector<GameEntity*> topLeft;
-
-	/*topRight.push_back(floor);
-	bottomRight.push_back(floor);
-	bottomLeft.push_back(floor);
-	topLeft.push_back(floor);*/
-
-	for (int i = 0; i < quadify.size(); i++)
-	{
-		if (quadify[i]->tag == std::string("Floor")  || quadify[i]->tag == std::string("Wall")) {
-			topRight.push_back(quadify[i]);
-			bottomRight.push_back(quadify[i]);
-			bottomLeft.push_back(quadify[i]);
-			topLeft.push_back(quadify[i]);
-		}
-
-		if (quadify[i]->position.x >= center.x && quadify[i]->position.z >= center.z && quadify[i]->tag != std::string("Floor") && quadify[i]->tag != std::string("Wall")) {
-			topRight.push_back(quadify[i]);
-		}
-		else if (quadify[i]->position.x >= center.x && quadify[i]->position.z <= center.z && quadify[i]->tag != std::string("Floor") && quadify[i]->tag != std::string("Wall")) {
-			bottomRight.push_back(quadify[i]);
-		}
-		else if (quadify[i]->position.x <= center.x && quadify[i]->position.z <= center.z && quadify[i]->tag != std::string("Floor") && quadify[i]->tag != std::string("Wall")) {
-			bottomLeft.push_back(quadify[i]);
-		}
-		else if (quadify[i]->position.x <= center.x && quadify[i]->position.z >= center.z && quadify[i]->tag != std::string("Floor") && quadify[i]->tag != std::string("Wall")) {
-			topLeft.push_back(quadify[i]);
-		}
-	}
-
-
-	//Updates the individual vectors for the regions
-	for (int i = 0; i < topRight.size(); i++)
-	{
-		topRight[i]->Update(topRight, i, sound);
-	}
-
-	for (int i = 0; i < bottomRight.size(); i++)
-	{
-		bottomRight[i]->Update(bottomRight, i, sound);
-	}
-
-	for (int i = 0; i < bottomLeft.size(); i++)
-	{
-		bottomLeft[i]->Update(bottomLeft, i, sound);
-	}
-
-	for (int i = 0; i < topLeft.size(); i++)
-	{
-		topLeft[i]->Update(topLeft, i, sound);
-	}
-}
-
-void UpdateGravityExample(GameEntity* gameObj)
-{
-	if (gameObj->position.y <= -7.f)
-	{
-		gameObj->position.y = -7.f;
-		gameObj->ApplyForce(glm::vec3(0.f, 2.f, 0.f));
+		soundPool->Play(bounceSound, time);
 	}
+	soundPool->Update();
 }
 
 // ========================================================== Update input based on cameras
@@ -1063,4 +597,42 @@ void CheckUpdateCameras()
 		cameraSwap = false;
 	}
 
-}
\ No newline at end of file
+}
+
+// ========================================================== L turns the simulation LOD on and off
+void CheckToggleLod()
+{
+	if (Input::GetInstance()->IsKeyDown(GLFW_KEY_L) && !lodToggle)
+	{
+		simulationLod->SetEnabled(!simulationLod->IsEnabled());
+		std::cout << "Simulation LOD " << (simulationLod->IsEnabled() ? "on" : "off") << std::endl;
+		lodToggle = true;
+	}
+	else if (!Input::GetInstance()->IsKeyDown(GLFW_KEY_L))
+	{
+		lodToggle = false;
+	}
+}
+
+// ========================================================== draw calls, state changes and culling from the last frame, in the title bar
+void ShowRenderStats(GLFWwindow* window, double time, const FrustumCuller* culler)
+{
+	if (time - lastRenderStatsTime < renderStatsInterval)
+	{
+		return;
+	}
+	lastRenderStatsTime = time;
+
+	const RenderStats& stats = GLStateCache::GetInstance()->GetLastFrameStats();
+	std::ostringstream title;
+	title << windowTitle
+		<< " | draws " << stats.drawCalls
+		<< " | instances " << stats.instances
+		<< " | programs " << stats.programChanges
+		<< " | vertex arrays " << stats.vertexArrayChanges
+		<< " | blend " << stats.blendChanges
+		<< " | skipped " << stats.skippedChanges
+		<< " | visible " << culler->GetVisibleCount()
+		<< " | culled " << culler->GetCulledCount();
+	glfwSetWindowTitle(window, title.str().c_str());
+}
@@ -1,50 +1,56 @@
 #include "Material.h"
+#include "CameraUniforms.h"
+#include "GLStateCache.h"
 
-Material::Material(GLuint shaderProgram)
+Material::Material(GLuint shaderProgram, GLuint instancedProgram)
 {
     this->shaderProgram = shaderProgram;
+	this->instancedProgram = instancedProgram;
+
+	//the locations are the same every frame, so find them now instead of on every bind
+	modelToWorldLoc = glGetUniformLocation(shaderProgram, "modelToWorld");
+	colorLoc = glGetUniformLocation(shaderProgram, "colorSet");
+
+	BindCameraBlock(shaderProgram);
+	BindCameraBlock(instancedProgram);
 }
 
 Material::~Material()
 {
 }
 
+//points the program's camera block at the buffer CameraUniforms keeps up to date
+void Material::BindCameraBlock(GLuint program)
+{
+	if (program == 0)
+	{
+		return;
+	}
+
+	GLuint blockIndex = glGetUniformBlockIndex(program, "CameraBlock");
+	if (blockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(program, blockIndex, CameraUniforms::BindingPoint);
+	}
+}
 
-
-void Material::Bind(Camera * camera, glm::mat4 worldMatrix, glm::vec3 color, float alpha)
+void Material::Bind(const glm::mat4& worldMatrix, glm::vec3 color, float alpha)
 {
-    //enable shader
-    //TODO - refactor this binding call to be managed by a RenderManager
-    //       the RenderManager can be in charge of grouping material with same
-    //       shaders together and passing certain uniforms on a per-frame or 
-    //       per-object basis.
-    glUseProgram(shaderProgram);
-
-    //get location of the view matrix in the shader
-    //TODO - cache this as a private varaible (on init) because the location is same every frame
-    GLuint viewMatLoc = glGetUniformLocation(
-        shaderProgram,  //the shader program to look for
-        "viewMatrix"    //the name of the variable
-    );
+    //enable shader (the cache skips it when the last material used the same program)
+    GLStateCache::GetInstance()->UseProgram(shaderProgram);
 
-    //pass the variable up to our shader
+	//only what's different per object, the camera is already in its uniform buffer
     glUniformMatrix4fv(
-        viewMatLoc,     //location of the uniform
-        1,              //'count' of the uniforms
-        GL_FALSE,       //we don't need to transpose this matrix
-        &(camera->GetView()[0][0])   //the location of the first index
+        modelToWorldLoc,    //location of the uniform
+        1,                  //'count' of the uniforms
+        GL_FALSE,           //we don't need to transpose this matrix
+        &(worldMatrix[0][0])    //the location of the first index
     );
+	glUniform4f(colorLoc, color.x, color.y, color.z, alpha);
+}
 
-	int colorLocation = glGetUniformLocation(shaderProgram, "colorSet");
-	glUniform4f(colorLocation, color.x, color.y, color.z, alpha);
-
-    //get projection matrix location, and feed the value
-    //TODO - cache this as a private varaible (on init) because the location is same every frame
-    GLuint projectionMatLoc = glGetUniformLocation(shaderProgram, "projectionMatrix");
-    glUniformMatrix4fv(projectionMatLoc, 1, GL_FALSE, &(camera->GetProjection()[0][0]));
-
-    //do the same for our model to world matrix
-    //TODO - cache this as a private varaible (on init) because the location is same every frame
-    GLuint modelToWorldLoc = glGetUniformLocation(shaderProgram, "modelToWorld");
-    glUniformMatrix4fv(modelToWorldLoc, 1, GL_FALSE, &(worldMatrix[0][0]));
+void Material::BindInstanced()
+{
+	//everything else comes in with the instances
+	GLStateCache::GetInstance()->UseProgram(instancedProgram);
 }
@@ -1,10 +1,10 @@
 #pragma once
 #include "stdafx.h"
-#include "Camera.h"
 
 /// <summary>
 /// Represents one material to apply to a renderable item, and handles sending 
 /// any uniform over from CPU to GPU.
+/// The camera isn't part of it, every program reads that from the CameraUniforms buffer
 /// </summary>
 class Material
 {
@@ -13,13 +13,23 @@ private:
 
     //handle to the shader program
     GLuint shaderProgram;
+
+	//same look, but reading the world matrix and color per instance (0 if there isn't one)
+	GLuint instancedProgram;
+
+	//uniform locations in shaderProgram, looked up once since they never change after linking
+	GLint modelToWorldLoc;
+	GLint colorLoc;
+
+	static void BindCameraBlock(GLuint program);
 public:
 
     /// <summary>
     /// Creates a 'material' for a certain shaderProgram
     /// </summary>
     /// <param name="shaderProgram"></param>
-	Material(GLuint shaderProgram);
+    /// <param name="instancedProgram">Program built from vertexShaderInstanced.glsl, for BindInstanced</param>
+	Material(GLuint shaderProgram, GLuint instancedProgram = 0);
 
     /// <summary>
     /// Destruction
@@ -29,13 +39,20 @@ public:
     /// <summary>
     /// Binds the data that's needed to the uniforms
     /// </summary>
-    /// <param name="camera">Pointer to the rendering camera</param>
     /// <param name="worldMatrix">Matrix from model to world space</param>
 	void Bind(
-		Camera* camera,
-		glm::mat4 worldMatrix,
+		const glm::mat4& worldMatrix,
 		glm::vec3 color,
 		float alpha
     );
+
+	/// <summary>
+	/// Binds the instanced program, the world matrix and color come from the instances
+	/// </summary>
+	void BindInstanced();
+
+	bool CanInstance() const { return instancedProgram != 0; }
+
+	GLuint GetShaderProgram() const { return shaderProgram; }
 };
 
@@ -1,25 +1,49 @@
 #include "Mesh.h"
+#include <cstddef>
+#include "GLStateCache.h"
+#include "MeshOptimizer.h"
 
 Mesh::Mesh()
 {
+	VBO = 0;
+	EBO = 0;
+	instancedVAO = 0;
+	instanceBuffer = 0;
 }
 
 Mesh::~Mesh()
 {
     glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	if (instancedVAO != 0)
+	{
+		glDeleteVertexArrays(1, &instancedVAO);
+	}
 }
 
-void Mesh::InitWithVertexArray(GLfloat vertices[], size_t count, GLuint shaderProgram)
+void Mesh::InitWithVertexArray(GLfloat vertices[], size_t count, GLuint shaderProgram, int floatsPerVertex)
+{
+	//every corner of a triangle list is its own vertex, merge the ones that are the same
+	std::vector<GLfloat> uniqueVertices;
+	std::vector<GLuint> indices;
+	MeshOptimizer::WeldVertices(vertices, count, floatsPerVertex, uniqueVertices, indices);
+
+	InitWithIndexedArray(uniqueVertices.data(), uniqueVertices.size(), indices.data(), indices.size(), shaderProgram, floatsPerVertex);
+}
+
+void Mesh::InitWithIndexedArray(GLfloat vertices[], size_t count, GLuint indices[], size_t indexCount, GLuint shaderProgram, int floatsPerVertex)
 {
 	lastShaderProgram = shaderProgram;
+	this->floatsPerVertex = floatsPerVertex;
+
     //allocate space for all these vertices
-    this->vertices = std::vector<GLfloat>(count);
-    memcpy(&(this->vertices[0]), vertices, count * sizeof(GLfloat));
+    this->vertices = std::vector<GLfloat>(vertices, vertices + count);
+	this->indices = std::vector<GLuint>(indices, indices + indexCount);
 
-    //vertCount is how many vertices we have
-    //since 3 floats make up one vertices, we divide by 3
-    //(yeah this is bad, and you should feel disgusted)
-    vertCount = count / 3;
+	//triangles in an order that reuses transformed vertices, then the vertices in the order they're used
+	MeshOptimizer::OptimizeVertexCache(this->indices, (int)(count / floatsPerVertex));
+	MeshOptimizer::OptimizeVertexFetch(this->vertices, floatsPerVertex, this->indices);
+	vertCount = (GLsizei)(this->vertices.size() / floatsPerVertex);
 
     //we create the VAO and VBO based off of all these data
     CreateBuffers(shaderProgram);
@@ -28,20 +52,61 @@ void Mesh::InitWithVertexArray(GLfloat vertices[], size_t count, GLuint shaderPr
 void Mesh::Render()
 {
     //set VAO and draw
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, vertCount);
+    GLStateCache* state = GLStateCache::GetInstance();
+    state->BindVertexArray(VAO);
+    state->DrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
+}
+
+void Mesh::EnableInstancing(GLuint instanceBuffer)
+{
+	if (instancedVAO == 0)
+	{
+		glGenVertexArrays(1, &instancedVAO);
+	}
+	this->instanceBuffer = instanceBuffer;
+	GLStateCache::GetInstance()->BindVertexArray(instancedVAO);
+
+	//the vertices and indices, same as the normal VAO but at the location the instanced shader fixes them to
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(GLfloat), (GLvoid*)0);
+	glEnableVertexAttribArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+	//a mat4 attribute is 4 vec4 columns, each one moves on once per instance instead of once per vertex
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	for (GLuint column = 0; column < 4; column++)
+	{
+		GLuint attribIndex = 1 + column;
+		glVertexAttribPointer(attribIndex, 4, GL_FLOAT, GL_FALSE, sizeof(MeshInstance),
+			(GLvoid*)(offsetof(MeshInstance, world) + column * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(attribIndex);
+		glVertexAttribDivisor(attribIndex, 1);
+	}
+	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(MeshInstance), (GLvoid*)offsetof(MeshInstance, color));
+	glEnableVertexAttribArray(5);
+	glVertexAttribDivisor(5, 1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	GLStateCache::GetInstance()->BindVertexArray(0);
+}
+
+void Mesh::RenderInstanced(GLsizei instanceCount)
+{
+	GLStateCache* state = GLStateCache::GetInstance();
+	state->BindVertexArray(instancedVAO);
+	state->DrawElementsInstanced(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0, instanceCount);
 }
 
 void Mesh::CreateBuffers(GLuint shaderProgram)
 {
     glGenVertexArrays(1, &VAO);	//create 1 VAO and store it
-    glBindVertexArray(VAO);		//tells OpenGL that this is our 'array' (descriptor)
+    GLStateCache::GetInstance()->BindVertexArray(VAO);		//tells OpenGL that this is our 'array' (descriptor)
 
     glGenBuffers(1, &VBO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);		//tells OpenGL that this is our 'array buffer' (memory)
     glBufferData(			//create a 'buffer store' (place to put this memory in GPU)						
         GL_ARRAY_BUFFER,
-        sizeof(GLfloat) * 3 * vertCount,	//the size of our buffer
+        sizeof(GLfloat) * vertices.size(),	//the size of our buffer
         &(vertices[0]),		                //pointer to starting loc
         GL_STATIC_DRAW);	                //'hints' at what this will be used for
 
@@ -52,11 +117,16 @@ void Mesh::CreateBuffers(GLuint shaderProgram)
         3,						//count of data (this case we have a vec3 -- which has 3 floats)
         GL_FLOAT,				//kind of data (as mentioned, this is a float!)
         GL_FALSE,				//should data be normalized?
-        3 * sizeof(GLfloat),	//stride - how many index to skip ahead to reach more of this data
+        floatsPerVertex * sizeof(GLfloat),	//stride - how many index to skip ahead to reach more of this data
         (GLvoid*)0);			//offset - how many index to skip to reach first value
     glEnableVertexAttribArray(attribIndex);	//enable what we just did earlier 
 
+	//the index buffer is remembered by the VAO, so it stays bound until the VAO is unbound
+	glGenBuffers(1, &EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), &(indices[0]), GL_STATIC_DRAW);
+
     //unbind things
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLStateCache::GetInstance()->BindVertexArray(0);
 }
@@ -7,9 +7,22 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <glm/glm.hpp>
 
 /// <summary>
-/// This represents on 'mesh' for our rendering pipeline
+/// What an instanced draw needs to know about each copy of the mesh, laid out the way
+/// vertexShaderInstanced.glsl reads it out of the instance buffer
+/// </summary>
+struct MeshInstance
+{
+	glm::mat4 world;    //model to world matrix
+	glm::vec4 color;    //rgb and alpha
+};
+
+/// <summary>
+/// This represents on 'mesh' for our rendering pipeline.
+/// Always drawn indexed: duplicate vertices are welded together and the triangles are
+/// reordered for the vertex cache when it's created (see MeshOptimizer)
 /// </summary>
 class Mesh
 {
@@ -25,22 +38,52 @@ public:
     ~Mesh();
 
     /// <summary>
-    /// Creates our VAO & VBO based on an array of vertices
+    /// Creates our VAO, VBO & index buffer based on an array of vertices (3 per triangle, no indices)
     /// </summary>
     /// <param name="vertices">The array of vertices</param>
-    /// <param name="count">The count of vertices</param>
+    /// <param name="count">The count of floats in the array</param>
     /// <param name="shaderProgram">The 'handle' to the shader program</param>
-    void InitWithVertexArray(GLfloat vertices[], size_t count, GLuint shaderProgram);
+    /// <param name="floatsPerVertex">Floats in each vertex, the position is always the first 3</param>
+    void InitWithVertexArray(GLfloat vertices[], size_t count, GLuint shaderProgram, int floatsPerVertex = 3);
+
+	/// <summary>
+	/// Creates our VAO, VBO & index buffer from vertices that are already indexed (like an imported model)
+	/// </summary>
+	/// <param name="count">The count of floats in the vertex array</param>
+	/// <param name="indices">3 per triangle</param>
+	/// <param name="floatsPerVertex">Floats in each vertex, the position is always the first 3</param>
+	void InitWithIndexedArray(GLfloat vertices[], size_t count, GLuint indices[], size_t indexCount, GLuint shaderProgram, int floatsPerVertex = 3);
     
     /// <summary>
     /// Bind our VAO and draw our shape!
     /// </summary>
     void Render();
-	//vector of vertices
+
+	/// <summary>
+	/// Sets up a second VAO that reads the vertices (and indices) at location 0 and a MeshInstance per instance out of
+	/// instanceBuffer (at the locations vertexShaderInstanced.glsl uses). Only needs doing once per buffer
+	/// </summary>
+	/// <param name="instanceBuffer">Buffer the instances get uploaded to before each RenderInstanced</param>
+	void EnableInstancing(GLuint instanceBuffer);
+
+	/// <summary>
+	/// Whether EnableInstancing has been called with this buffer
+	/// </summary>
+	bool IsInstancing(GLuint instanceBuffer) const { return instancedVAO != 0 && this->instanceBuffer == instanceBuffer; }
+
+	/// <summary>
+	/// Draws instanceCount copies in one call, with whatever is at the start of the instance buffer
+	/// </summary>
+	void RenderInstanced(GLsizei instanceCount);
+	//vector of vertices, each one floatsPerVertex floats
 	std::vector<GLfloat> vertices;
 
-	//how many vertices we have
+	//3 per triangle, in the order they're drawn
+	std::vector<GLuint> indices;
+
+	//how many (different) vertices we have
 	GLsizei vertCount;
+	GLsizei floatsPerVertex;
 	GLuint lastShaderProgram;
 private:
 
@@ -50,6 +93,13 @@ private:
 
     //our VBO
     GLuint VBO;
+
+	//our index buffer (EBO), part of both VAOs
+	GLuint EBO;
+
+	//VAO for instanced draws and the buffer it reads the instances from (0 until EnableInstancing)
+	GLuint instancedVAO;
+	GLuint instanceBuffer;
     
 
     /// <summary>
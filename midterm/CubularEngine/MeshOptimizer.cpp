@@ -0,0 +1,283 @@
+#include "MeshOptimizer.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+void MeshOptimizer::WeldVertices(const float* vertices, size_t count, int floatsPerVertex,
+	std::vector<float>& uniqueVertices, std::vector<unsigned int>& indices)
+{
+	size_t vertexCount = count / floatsPerVertex;
+	uniqueVertices.clear();
+	indices.resize(vertexCount);
+
+	//open addressing table of indices into uniqueVertices, at least twice as big as it can get
+	size_t tableSize = 1;
+	while (tableSize < vertexCount * 2)
+	{
+		tableSize *= 2;
+	}
+	const unsigned int empty = 0xFFFFFFFF;
+	std::vector<unsigned int> table(tableSize, empty);
+
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		const float* vertex = vertices + v * floatsPerVertex;
+
+		//FNV-1a over the float bits, adding 0 first so -0 and 0 hash the same (they compare equal below)
+		unsigned int hash = 2166136261u;
+		for (int f = 0; f < floatsPerVertex; f++)
+		{
+			float value = vertex[f] + 0.f;
+			unsigned int bits;
+			memcpy(&bits, &value, sizeof(bits));
+			hash = (hash ^ bits) * 16777619u;
+		}
+
+		size_t slot = hash & (tableSize - 1);
+		while (true)
+		{
+			unsigned int unique = table[slot];
+			if (unique == empty)
+			{
+				unique = (unsigned int)(uniqueVertices.size() / floatsPerVertex);
+				uniqueVertices.insert(uniqueVertices.end(), vertex, vertex + floatsPerVertex);
+				table[slot] = unique;
+				indices[v] = unique;
+				break;
+			}
+
+			const float* existing = uniqueVertices.data() + unique * floatsPerVertex;
+			bool same = true;
+			for (int f = 0; f < floatsPerVertex && same; f++)
+			{
+				same = existing[f] == vertex[f];
+			}
+			if (same)
+			{
+				indices[v] = unique;
+				break;
+			}
+			slot = (slot + 1) & (tableSize - 1);
+		}
+	}
+}
+
+//==================================================================== Forsyth vertex cache optimisation
+
+//the scoring from the paper: the last triangle's vertices get a fixed score (so the next triangle
+//doesn't just reuse the same three), older cache entries fall off with a power curve,
+//and vertices with few triangles left get a boost so they're finished off instead of left as stragglers
+static const float CacheDecayPower = 1.5f;
+static const float LastTriangleScore = 0.75f;
+static const float ValenceBoostScale = 2.f;
+static const float ValenceBoostPower = 0.5f;
+
+static float GetVertexScore(int cachePosition, int remainingTriangles)
+{
+	if (remainingTriangles == 0)
+	{
+		return -1.f;
+	}
+
+	float score = 0.f;
+	if (cachePosition >= 0)
+	{
+		if (cachePosition < 3)
+		{
+			score = LastTriangleScore;
+		}
+		else
+		{
+			float scaler = 1.f / (MeshOptimizer::CacheSize - 3);
+			score = powf(1.f - (cachePosition - 3) * scaler, CacheDecayPower);
+		}
+	}
+
+	score += ValenceBoostScale * powf((float)remainingTriangles, -ValenceBoostPower);
+	return score;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, int vertexCount)
+{
+	int triangleCount = (int)indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	//every vertex's triangles, as ranges of one shared array
+	std::vector<int> triangleStart(vertexCount + 1, 0);
+	for (int i = 0; i < triangleCount * 3; i++)
+	{
+		triangleStart[indices[i] + 1]++;
+	}
+	for (int v = 0; v < vertexCount; v++)
+	{
+		triangleStart[v + 1] += triangleStart[v];
+	}
+	std::vector<int> vertexTriangles(triangleCount * 3);
+	std::vector<int> remaining(vertexCount, 0);      //triangles not drawn yet, they're kept at the front of the vertex's range
+	for (int t = 0; t < triangleCount; t++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			unsigned int v = indices[t * 3 + k];
+			vertexTriangles[triangleStart[v] + remaining[v]++] = t;
+		}
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (int v = 0; v < vertexCount; v++)
+	{
+		vertexScore[v] = GetVertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> drawn(triangleCount, false);
+	for (int t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+	}
+
+	//the cache, most recent first, with room for the 3 vertices pushed on before the oldest fall off
+	std::vector<int> cache;
+	std::vector<int> newCache;
+	cache.reserve(CacheSize + 3);
+	newCache.reserve(CacheSize + 3);
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+
+	int bestTriangle = -1;
+	int scanCursor = 0;     //everything before this is drawn, for when the cache has nothing left to offer
+	for (int drawnCount = 0; drawnCount < triangleCount; drawnCount++)
+	{
+		if (bestTriangle < 0)
+		{
+			//nothing in the cache touches an undrawn triangle, take the best of the rest
+			float bestScore = -1.f;
+			for (int t = scanCursor; t < triangleCount; t++)
+			{
+				if (!drawn[t] && triangleScore[t] > bestScore)
+				{
+					bestScore = triangleScore[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		const unsigned int* triangle = &indices[bestTriangle * 3];
+		result.insert(result.end(), triangle, triangle + 3);
+		drawn[bestTriangle] = true;
+		while (scanCursor < triangleCount && drawn[scanCursor])
+		{
+			scanCursor++;
+		}
+
+		//the triangle's vertices go to the front of the cache and lose it from their undrawn list
+		newCache.clear();
+		for (int k = 0; k < 3; k++)
+		{
+			int v = (int)triangle[k];
+			if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+			{
+				newCache.push_back(v);
+			}
+
+			int* begin = &vertexTriangles[triangleStart[v]];
+			int* end = begin + remaining[v];
+			std::swap(*std::find(begin, end, bestTriangle), *(end - 1));
+			remaining[v]--;
+		}
+		for (int i = 0; i < cache.size(); i++)
+		{
+			int v = cache[i];
+			if (v != (int)triangle[0] && v != (int)triangle[1] && v != (int)triangle[2])
+			{
+				newCache.push_back(v);
+			}
+		}
+
+		//rescore everything whose place in the cache moved (including the ones that just fell out)
+		for (int i = 0; i < newCache.size(); i++)
+		{
+			int v = newCache[i];
+			cachePosition[v] = i < CacheSize ? i : -1;
+			vertexScore[v] = GetVertexScore(cachePosition[v], remaining[v]);
+		}
+
+		//the next triangle is the best one touching the cache
+		bestTriangle = -1;
+		float bestScore = -1.f;
+		for (int i = 0; i < newCache.size(); i++)
+		{
+			int v = newCache[i];
+			for (int n = 0; n < remaining[v]; n++)
+			{
+				int t = vertexTriangles[triangleStart[v] + n];
+				float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+				triangleScore[t] = score;
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = t;
+				}
+			}
+		}
+
+		if (newCache.size() > CacheSize)
+		{
+			newCache.resize(CacheSize);
+		}
+		cache.swap(newCache);
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<float>& vertices, int floatsPerVertex, std::vector<unsigned int>& indices)
+{
+	int vertexCount = (int)vertices.size() / floatsPerVertex;
+	const unsigned int unused = 0xFFFFFFFF;
+	std::vector<unsigned int> remap(vertexCount, unused);
+	std::vector<float> reordered;
+	reordered.reserve(vertices.size());
+
+	for (int i = 0; i < indices.size(); i++)
+	{
+		unsigned int& newIndex = remap[indices[i]];
+		if (newIndex == unused)
+		{
+			newIndex = (unsigned int)(reordered.size() / floatsPerVertex);
+			const float* vertex = vertices.data() + indices[i] * floatsPerVertex;
+			reordered.insert(reordered.end(), vertex, vertex + floatsPerVertex);
+		}
+		indices[i] = newIndex;
+	}
+
+	//vertices no triangle uses are dropped
+	vertices.swap(reordered);
+}
+
+float MeshOptimizer::GetCacheMissRatio(const std::vector<unsigned int>& indices, int vertexCount, int cacheSize)
+{
+	int triangleCount = (int)indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return 0.f;
+	}
+
+	//when each vertex went into the FIFO, it's still there if fewer than cacheSize went in after it
+	std::vector<int> insertedAt(vertexCount, -cacheSize - 1);
+	int inserts = 0;
+	for (int i = 0; i < triangleCount * 3; i++)
+	{
+		unsigned int v = indices[i];
+		if (inserts - insertedAt[v] > cacheSize)
+		{
+			insertedAt[v] = inserts++;
+		}
+	}
+	return (float)inserts / triangleCount;
+}
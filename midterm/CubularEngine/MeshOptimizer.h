@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+/// <summary>
+/// Turns triangle lists into indexed meshes the GPU can draw with less vertex shader work.
+/// Doesn't touch GL, so the tools can run it too. Vertices are runs of floatsPerVertex floats
+/// (position first), indices are 3 per triangle
+/// </summary>
+class MeshOptimizer
+{
+public:
+	//size of the vertex cache the triangle order is tuned for (recent GPUs keep at least this many)
+	static const int CacheSize = 32;
+
+	/// <summary>
+	/// Merges vertices that are exactly the same into one and writes the indices that rebuild the original list
+	/// </summary>
+	/// <param name="vertices">The unindexed vertices, count floats long</param>
+	/// <param name="uniqueVertices">Gets each different vertex once, in the order they first appear</param>
+	/// <param name="indices">Gets one index into uniqueVertices for every original vertex</param>
+	static void WeldVertices(const float* vertices, size_t count, int floatsPerVertex,
+		std::vector<float>& uniqueVertices, std::vector<unsigned int>& indices);
+
+	/// <summary>
+	/// Reorders the triangles so that vertices are reused while they're still in the post transform cache
+	/// (Tom Forsyth's linear speed vertex cache optimisation). Every triangle keeps its winding
+	/// </summary>
+	static void OptimizeVertexCache(std::vector<unsigned int>& indices, int vertexCount);
+
+	/// <summary>
+	/// Renumbers the vertices in the order the triangles first use them, so the vertex fetches walk the buffer forwards
+	/// </summary>
+	static void OptimizeVertexFetch(std::vector<float>& vertices, int floatsPerVertex, std::vector<unsigned int>& indices);
+
+	/// <summary>
+	/// Vertices a FIFO cache of cacheSize would transform per triangle (3 is no reuse at all, 0.5 is the best a big grid gets)
+	/// </summary>
+	static float GetCacheMissRatio(const std::vector<unsigned int>& indices, int vertexCount, int cacheSize);
+};
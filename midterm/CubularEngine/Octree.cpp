@@ -0,0 +1,347 @@
+#include "Octree.h"
+
+Octree::Octree(glm::vec3 center, float halfSize, int maxDepth, int splitThreshold)
+{
+	this->maxDepth = maxDepth;
+	this->splitThreshold = splitThreshold;
+
+	//the root always exists, everything starts out in it
+	Node root;
+	root.center = center;
+	root.halfSize = halfSize;
+	root.depth = 0;
+	root.parent = -1;
+	root.firstChild = -1;
+	root.subtreeCount = 0;
+	nodes.push_back(root);
+}
+
+Octree::~Octree()
+{
+}
+
+//checks if an object can be stored in this node (its center is in the cell and it isn't bigger than the cell)
+bool Octree::Fits(const Node& node, const AABB& bounds) const
+{
+	//the root holds anything, even things outside of it
+	if (node.parent < 0)
+	{
+		return true;
+	}
+
+	glm::vec3 center = bounds.GetCenter();
+	glm::vec3 extents = bounds.GetExtents();
+
+	return glm::abs(center.x - node.center.x) <= node.halfSize &&
+		glm::abs(center.y - node.center.y) <= node.halfSize &&
+		glm::abs(center.z - node.center.z) <= node.halfSize &&
+		extents.x <= node.halfSize && extents.y <= node.halfSize && extents.z <= node.halfSize;
+}
+
+//gets the child cell a point is in (node must not be a leaf)
+int Octree::ChildFor(const Node& node, glm::vec3 point) const
+{
+	int index = 0;
+	if (point.x >= node.center.x) { index |= 1; }
+	if (point.y >= node.center.y) { index |= 2; }
+	if (point.z >= node.center.z) { index |= 4; }
+	return node.firstChild + index;
+}
+
+//the loose bounds are twice the size of the cell, so anything that Fits is always inside them
+AABB Octree::LooseBounds(const Node& node) const
+{
+	float looseSize = node.halfSize * 2.f;
+	return AABB::FromCenter(node.center, glm::vec3(looseSize, looseSize, looseSize));
+}
+
+void Octree::Update(const std::vector<BroadphaseProxy>& proxies)
+{
+	//proxies were removed from the end of the list
+	while (entries.size() > proxies.size())
+	{
+		Remove((unsigned int)entries.size() - 1);
+		entries.pop_back();
+	}
+
+	//proxies were added to the end of the list
+	size_t oldCount = entries.size();
+	entries.resize(proxies.size());
+	for (size_t i = oldCount; i < proxies.size(); i++)
+	{
+		entries[i].proxy = proxies[i];
+		entries[i].node = -1;
+		entries[i].slot = -1;
+		Insert((unsigned int)i);
+	}
+
+	//only objects that left their cell get re-inserted
+	for (size_t i = 0; i < oldCount; i++)
+	{
+		Entry& entry = entries[i];
+		bool moved = entry.proxy.bounds != proxies[i].bounds;
+		entry.proxy = proxies[i];
+
+		if (!moved)
+		{
+			continue;
+		}
+
+		const Node& node = nodes[entry.node];
+		glm::vec3 center = entry.proxy.bounds.GetCenter();
+		if (Fits(node, entry.proxy.bounds) &&
+			(node.firstChild < 0 || !Fits(nodes[ChildFor(node, center)], entry.proxy.bounds)))
+		{
+			continue;
+		}
+
+		Remove((unsigned int)i);
+		Insert((unsigned int)i);
+	}
+}
+
+void Octree::FindPairs(std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+
+	for (unsigned int i = 0; i < entries.size(); i++)
+	{
+		//static objects don't need to look for anything, the dynamic ones will find them
+		const BroadphaseProxy& proxy = entries[i].proxy;
+		if (proxy.isStatic || entries[i].node < 0)
+		{
+			continue;
+		}
+
+		stack.clear();
+		stack.push_back(0);
+		while (!stack.empty())
+		{
+			const Node& node = nodes[stack.back()];
+			stack.pop_back();
+
+			for (int k = 0; k < node.objects.size(); k++)
+			{
+				unsigned int other = node.objects[k];
+				const BroadphaseProxy& otherProxy = entries[other].proxy;
+
+				//dynamic pairs are found from both sides, so only keep the one from the smaller id
+				if (other == i || (!otherProxy.isStatic && other < i))
+				{
+					continue;
+				}
+
+				if (ShouldPair(proxy, otherProxy) && proxy.bounds.Overlaps(otherProxy.bounds))
+				{
+					CollisionPair pair;
+					pair.a = glm::min(i, other);
+					pair.b = glm::max(i, other);
+					pairs.push_back(pair);
+				}
+			}
+
+			if (node.firstChild >= 0)
+			{
+				for (int c = 0; c < 8; c++)
+				{
+					const Node& child = nodes[node.firstChild + c];
+					if (child.subtreeCount > 0 && LooseBounds(child).Overlaps(proxy.bounds))
+					{
+						stack.push_back(node.firstChild + c);
+					}
+				}
+			}
+		}
+	}
+}
+
+void Octree::Query(const AABB& bounds, std::vector<unsigned int>& results)
+{
+	stack.clear();
+	stack.push_back(0);
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		for (int k = 0; k < node.objects.size(); k++)
+		{
+			if (entries[node.objects[k]].proxy.bounds.Overlaps(bounds))
+			{
+				results.push_back(node.objects[k]);
+			}
+		}
+
+		if (node.firstChild >= 0)
+		{
+			for (int c = 0; c < 8; c++)
+			{
+				const Node& child = nodes[node.firstChild + c];
+				if (child.subtreeCount > 0 && LooseBounds(child).Overlaps(bounds))
+				{
+					stack.push_back(node.firstChild + c);
+				}
+			}
+		}
+	}
+}
+
+//walks down from the root to the deepest cell the object fits in, splitting full leaves on the way
+void Octree::Insert(unsigned int id)
+{
+	const AABB& bounds = entries[id].proxy.bounds;
+	glm::vec3 center = bounds.GetCenter();
+
+	int current = 0;
+	while (true)
+	{
+		if (nodes[current].firstChild < 0)
+		{
+			if (nodes[current].objects.size() >= splitThreshold && nodes[current].depth < maxDepth)
+			{
+				Split(current);
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		int child = ChildFor(nodes[current], center);
+		if (!Fits(nodes[child], bounds))
+		{
+			break;
+		}
+		current = child;
+	}
+
+	AddToNode(current, id);
+}
+
+void Octree::Remove(unsigned int id)
+{
+	Entry& entry = entries[id];
+	if (entry.node < 0)
+	{
+		return;
+	}
+
+	//swap the last object into this slot
+	Node& node = nodes[entry.node];
+	unsigned int last = node.objects.back();
+	node.objects[entry.slot] = last;
+	entries[last].slot = entry.slot;
+	node.objects.pop_back();
+
+	for (int n = entry.node; n >= 0; n = nodes[n].parent)
+	{
+		nodes[n].subtreeCount--;
+	}
+
+	int oldNode = entry.node;
+	entry.node = -1;
+	entry.slot = -1;
+
+	TryMerge(oldNode);
+}
+
+void Octree::AddToNode(int nodeIndex, unsigned int id)
+{
+	entries[id].node = nodeIndex;
+	entries[id].slot = (int)nodes[nodeIndex].objects.size();
+	nodes[nodeIndex].objects.push_back(id);
+
+	for (int n = nodeIndex; n >= 0; n = nodes[n].parent)
+	{
+		nodes[n].subtreeCount++;
+	}
+}
+
+//gives a leaf 8 children and pushes down every object that fits in one of them
+void Octree::Split(int nodeIndex)
+{
+	int first;
+	if (!freeBlocks.empty())
+	{
+		first = freeBlocks.back();
+		freeBlocks.pop_back();
+	}
+	else
+	{
+		first = (int)nodes.size();
+		nodes.resize(nodes.size() + 8);
+	}
+
+	float childHalf = nodes[nodeIndex].halfSize * 0.5f;
+	for (int c = 0; c < 8; c++)
+	{
+		Node& child = nodes[first + c];
+		glm::vec3 offset(
+			(c & 1) ? childHalf : -childHalf,
+			(c & 2) ? childHalf : -childHalf,
+			(c & 4) ? childHalf : -childHalf);
+		child.center = nodes[nodeIndex].center + offset;
+		child.halfSize = childHalf;
+		child.depth = nodes[nodeIndex].depth + 1;
+		child.parent = nodeIndex;
+		child.firstChild = -1;
+		child.subtreeCount = 0;
+		child.objects.clear();
+	}
+	nodes[nodeIndex].firstChild = first;
+
+	std::vector<unsigned int> objects;
+	objects.swap(nodes[nodeIndex].objects);
+	for (int k = 0; k < objects.size(); k++)
+	{
+		unsigned int id = objects[k];
+		const AABB& bounds = entries[id].proxy.bounds;
+		int child = ChildFor(nodes[nodeIndex], bounds.GetCenter());
+		int target = Fits(nodes[child], bounds) ? child : nodeIndex;
+
+		entries[id].node = target;
+		entries[id].slot = (int)nodes[target].objects.size();
+		nodes[target].objects.push_back(id);
+		if (target != nodeIndex)
+		{
+			nodes[target].subtreeCount++;
+		}
+	}
+}
+
+//collapses children back into their parent once a branch is mostly empty
+//(half the split threshold, so a cell doesn't keep splitting and merging every frame)
+void Octree::TryMerge(int nodeIndex)
+{
+	int current = nodes[nodeIndex].firstChild < 0 ? nodes[nodeIndex].parent : nodeIndex;
+
+	while (current >= 0 && nodes[current].subtreeCount <= splitThreshold / 2)
+	{
+		int first = nodes[current].firstChild;
+		for (int c = 0; c < 8; c++)
+		{
+			if (nodes[first + c].firstChild >= 0)
+			{
+				return;
+			}
+		}
+
+		for (int c = 0; c < 8; c++)
+		{
+			Node& child = nodes[first + c];
+			for (int k = 0; k < child.objects.size(); k++)
+			{
+				unsigned int id = child.objects[k];
+				entries[id].node = current;
+				entries[id].slot = (int)nodes[current].objects.size();
+				nodes[current].objects.push_back(id);
+			}
+			child.objects.clear();
+			child.subtreeCount = 0;
+		}
+
+		nodes[current].firstChild = -1;
+		freeBlocks.push_back(first);
+		current = nodes[current].parent;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "Broadphase.h"
+
+/// <summary>
+/// Persistent loose octree. Each node's bounds are twice the size of its cell, so an object only
+/// needs its center inside a cell to be stored there, and only has to be moved when its center
+/// crosses a cell boundary (or it grows too big for the cell).
+/// </summary>
+class Octree : public Broadphase
+{
+private:
+	struct Node
+	{
+		glm::vec3 center;       //center of the (tight) cell
+		float halfSize;         //half the width of the tight cell, loose bounds are twice this
+		int depth;
+		int parent;
+		int firstChild;         //index of the first of 8 children, -1 if this is a leaf
+		int subtreeCount;       //how many objects live in this node and below it
+		std::vector<unsigned int> objects;
+	};
+
+	struct Entry
+	{
+		BroadphaseProxy proxy;
+		int node;               //node the object is stored in, -1 if not in the tree
+		int slot;               //index in that node's object list
+	};
+
+	std::vector<Node> nodes;
+	std::vector<int> freeBlocks;    //first index of unused blocks of 8 nodes
+	std::vector<Entry> entries;
+	std::vector<int> stack;         //traversal stack, kept around so queries don't allocate
+
+	int maxDepth;
+	int splitThreshold;
+
+	bool Fits(const Node& node, const AABB& bounds) const;
+	int ChildFor(const Node& node, glm::vec3 point) const;
+	AABB LooseBounds(const Node& node) const;
+
+	void Insert(unsigned int id);
+	void Remove(unsigned int id);
+	void AddToNode(int nodeIndex, unsigned int id);
+	void Split(int nodeIndex);
+	void TryMerge(int nodeIndex);
+
+public:
+	/// <summary>
+	/// Creates an empty tree
+	/// </summary>
+	/// <param name="center">Center of the root cell</param>
+	/// <param name="halfSize">Half the width of the root cell (objects outside it are kept in the root)</param>
+	/// <param name="maxDepth">How many times a cell can be split</param>
+	/// <param name="splitThreshold">How many objects a leaf holds before it splits</param>
+	Octree(glm::vec3 center, float halfSize, int maxDepth, int splitThreshold);
+
+	/// <summary>
+	/// Destruction
+	/// </summary>
+	~Octree();
+
+	/// <summary>
+	/// Re-inserts only the proxies that left their cell since the last update
+	/// </summary>
+	void Update(const std::vector<BroadphaseProxy>& proxies) override;
+
+	/// <summary>
+	/// Queries the tree with each dynamic object to build the list of overlapping pairs
+	/// </summary>
+	void FindPairs(std::vector<CollisionPair>& pairs) override;
+
+	/// <summary>
+	/// Gets every object whose bounds overlap the given box
+	/// </summary>
+	void Query(const AABB& bounds, std::vector<unsigned int>& results);
+
+	/// <summary>
+	/// How many nodes are in use (for debugging how adaptive the tree is)
+	/// </summary>
+	int GetNodeCount() const { return (int)nodes.size() - (int)freeBlocks.size() * 8; }
+};
@@ -0,0 +1,736 @@
+#include "PhysicsWorld.h"
+#include <algorithm>
+#include <chrono>
+
+//how many bodies one task handles at least for the per body passes
+static const int MinTaskSize = 1024;
+
+//a body slower than this (per step) for StepsToSleep steps in a row is resting
+static const float SleepSpeed = 0.005f;
+static const int StepsToSleep = 30;
+
+//contacts start from last step's impulses, so a few passes are enough even for stacks
+static const int SolverIterations = 3;
+
+//bodies that moved less than this relative to each other since last step reuse last step's contact
+static const float ContactTolerance = 0.0001f;
+
+//how many things a fast body can bounce off in one step before the rest of its move is dropped
+static const int MaxSweepSteps = 4;
+
+const float PhysicsWorld::BaseTimeStep = 1.f / 60.f;
+
+PhysicsWorld::PhysicsWorld(Broadphase* broadphase, ThreadPool* threadPool, Arena* arena)
+	: contactCache(arena)
+{
+	this->broadphase = broadphase;
+	this->threadPool = threadPool;
+	eventQueue = nullptr;
+	stepScale = 1.f;
+	stepCount = 0;
+	deferredCount = 0;
+	timings = StepTimings();
+	floorTag = TagRegistry::GetInstance()->Intern("Floor");
+
+	//everything collides with everything, except scenery with itself and decorations with anything
+	for (int layer = 0; layer < MaxCollisionLayers; layer++)
+	{
+		layerMasks[layer] = 0xffffffff;
+	}
+	SetLayersCollide(LayerScenery, LayerScenery, false);
+	for (int layer = 0; layer < MaxCollisionLayers; layer++)
+	{
+		SetLayersCollide(LayerDecoration, layer, false);
+	}
+}
+
+PhysicsWorld::~PhysicsWorld()
+{
+}
+
+unsigned int PhysicsWorld::CreateBody(glm::vec3 position, glm::vec3 collider, float weight, bool applyPhysics, TagId tag)
+{
+	//reuse an old handle if there is one
+	unsigned int body;
+	if (!freeHandles.empty())
+	{
+		body = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	else
+	{
+		body = (unsigned int)handleToIndex.size();
+		handleToIndex.push_back(0);
+	}
+
+	handleToIndex[body] = (unsigned int)positions.size();
+	indexToHandle.push_back(body);
+
+	positions.push_back(position);
+	previousPositions.push_back(position);
+	velocities.push_back(glm::vec3(0.f, 0.f, 0.f));
+	colliders.push_back(collider);
+	weights.push_back(weight);
+	this->applyPhysics.push_back(applyPhysics);
+	applyGravity.push_back(true);
+	sleeping.push_back(false);
+	restingSteps.push_back(0);
+	reportCollisions.push_back(false);
+	restitutions.push_back(tag == floorTag ? 0.f : 1.f);   //the floor soaks up bounces, everything else bounces back fully
+	tags.push_back(tag);
+	layers.push_back(collider == glm::vec3(0.f, 0.f, 0.f) ? LayerDecoration : LayerDefault);
+	updateIntervals.push_back(1);
+	pendingScales.push_back(0.f);
+	pendingLifts.push_back(0.f);
+	deferred.push_back(false);
+
+	return body;
+}
+
+void PhysicsWorld::DestroyBody(unsigned int body)
+{
+	//move the last body into this one's slot so the arrays stay packed
+	unsigned int index = handleToIndex[body];
+	unsigned int last = (unsigned int)positions.size() - 1;
+
+	positions[index] = positions[last];
+	previousPositions[index] = previousPositions[last];
+	velocities[index] = velocities[last];
+	colliders[index] = colliders[last];
+	weights[index] = weights[last];
+	applyPhysics[index] = applyPhysics[last];
+	applyGravity[index] = applyGravity[last];
+	sleeping[index] = sleeping[last];
+	restingSteps[index] = restingSteps[last];
+	reportCollisions[index] = reportCollisions[last];
+	restitutions[index] = restitutions[last];
+	tags[index] = tags[last];
+	layers[index] = layers[last];
+	updateIntervals[index] = updateIntervals[last];
+	pendingScales[index] = pendingScales[last];
+	pendingLifts[index] = pendingLifts[last];
+	deferred[index] = deferred[last];
+	indexToHandle[index] = indexToHandle[last];
+	handleToIndex[indexToHandle[index]] = index;
+
+	positions.pop_back();
+	previousPositions.pop_back();
+	velocities.pop_back();
+	colliders.pop_back();
+	weights.pop_back();
+	applyPhysics.pop_back();
+	applyGravity.pop_back();
+	sleeping.pop_back();
+	restingSteps.pop_back();
+	reportCollisions.pop_back();
+	restitutions.pop_back();
+	tags.pop_back();
+	layers.pop_back();
+	updateIntervals.pop_back();
+	pendingScales.pop_back();
+	pendingLifts.pop_back();
+	deferred.pop_back();
+	indexToHandle.pop_back();
+
+	contactCache.RemoveBody(body);
+	freeHandles.push_back(body);
+}
+
+void PhysicsWorld::Step(float timeStep)
+{
+	//time since the last lap, in milliseconds
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point lapStart = Clock::now();
+	auto lap = [&lapStart]()
+	{
+		Clock::time_point now = Clock::now();
+		double milliseconds = std::chrono::duration<double, std::milli>(now - lapStart).count();
+		lapStart = now;
+		return milliseconds;
+	};
+
+	stepScale = timeStep / BaseTimeStep;
+
+	//anything moved between steps (SetPosition) counts as part of this step's movement
+	previousPositions = positions;
+
+	DeferBodies();
+	ApplyGravity();
+	double gravityTime = lap();
+	UpdateBroadphase();
+	timings.broadphase = lap();
+	BuildIslands();
+	timings.islands = lap();
+	FindContacts();
+	timings.narrowphase = lap();
+	SolveIslands();
+	UpdateSleeping();
+	SweepFastBodies();
+	timings.response = lap();
+	Integrate();
+	timings.integration = gravityTime + lap();
+	stepCount++;
+}
+
+//picks the bodies that sit this step out, everything that can move banks the step's time until it's stepped
+void PhysicsWorld::DeferBodies()
+{
+	for (unsigned int i = 0; i < positions.size(); i++)
+	{
+		pendingScales[i] += stepScale;
+		int interval = updateIntervals[i];
+		deferred[i] = applyPhysics[i] && !sleeping[i] && interval > 1 && (stepCount + indexToHandle[i]) % interval != 0;
+	}
+}
+
+void PhysicsWorld::ApplyGravity()
+{
+	int count = (int)velocities.size();
+	int tasks = GetTaskCount(count);
+	RunTasks(tasks, [&](int task, int thread)
+	{
+		int begin = (int)((long long)count * task / tasks);
+		int end = (int)((long long)count * (task + 1) / tasks);
+		for (int i = begin; i < end; i++)
+		{
+			if (!applyPhysics[i])
+			{
+				velocities[i] = glm::vec3(0.f, 0.f, 0.f);
+			}
+			else if (applyGravity[i] && !sleeping[i])
+			{
+				//deferred bodies get theirs a step at a time too, but they only move with the velocity they end up with,
+				//which is lower than the one they had in each of the earlier banked steps. every earlier step would
+				//have moved this step's pull times its length higher, so that's banked to be added back when they move
+				float pull = .0098f * stepScale;
+				velocities[i].y -= pull;
+				pendingLifts[i] += pull * (pendingScales[i] - stepScale);
+			}
+		}
+	});
+}
+
+//syncs the broadphase with every body that can collide with something and grabs the pairs
+void PhysicsWorld::UpdateBroadphase()
+{
+	proxies.clear();
+	proxyBodies.clear();
+	sweeping.assign(positions.size(), false);
+	for (unsigned int i = 0; i < positions.size(); i++)
+	{
+		unsigned int collisionMask = layerMasks[layers[i]];
+		if (collisionMask == 0)
+		{
+			continue;
+		}
+
+		BroadphaseProxy proxy;
+		proxy.bounds = AABB::FromCenter(positions[i], colliders[i]);
+		if (IsMoving(i) && IsFast(i))
+		{
+			//cover the whole path, so anything it could hit on the way gets paired with it
+			AABB end = AABB::FromCenter(positions[i] + GetPendingDisplacement(i), colliders[i]);
+			proxy.bounds = AABB(glm::min(proxy.bounds.min, end.min), glm::max(proxy.bounds.max, end.max));
+			sweeping[i] = true;
+		}
+		proxy.isStatic = !IsMoving(i);   //sleeping bodies only wait to be hit
+		proxy.layerBit = 1u << layers[i];
+		proxy.collisionMask = collisionMask;
+		proxies.push_back(proxy);
+		proxyBodies.push_back(i);
+	}
+
+	broadphase->Update(proxies);
+	broadphase->FindPairs(pairs);
+}
+
+//groups the moving bodies that touch each other (through moving bodies only, static ones are shared)
+//and sorts the pairs by which island they belong to
+void PhysicsWorld::BuildIslands()
+{
+	//a moving body touching a sleeping one wakes it up (sleeping ones never pair with each other),
+	//and one touching a deferred body brings it into this step, so the contact pushes both of them
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		unsigned int a = proxyBodies[pairs[i].a];
+		unsigned int b = proxyBodies[pairs[i].b];
+		if (sleeping[a] && IsMoving(b))
+		{
+			Wake(a);
+		}
+		else if (sleeping[b] && IsMoving(a))
+		{
+			Wake(b);
+		}
+		else if (deferred[a] && IsMoving(b))
+		{
+			deferred[a] = false;
+		}
+		else if (deferred[b] && IsMoving(a))
+		{
+			deferred[b] = false;
+		}
+	}
+
+	unsigned int bodyCount = (unsigned int)positions.size();
+	islandParents.resize(bodyCount);
+	for (unsigned int i = 0; i < bodyCount; i++)
+	{
+		islandParents[i] = i;
+	}
+
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		unsigned int a = proxyBodies[pairs[i].a];
+		unsigned int b = proxyBodies[pairs[i].b];
+		if (IsMoving(a) && IsMoving(b))
+		{
+			//the smaller index always ends up as the root
+			unsigned int rootA = FindIsland(a);
+			unsigned int rootB = FindIsland(b);
+			if (rootA < rootB)
+			{
+				islandParents[rootB] = rootA;
+			}
+			else if (rootB < rootA)
+			{
+				islandParents[rootA] = rootB;
+			}
+		}
+	}
+
+	//number the islands in body order, a root comes before everything else in its island
+	bodyIslands.assign(bodyCount, -1);
+	int islandCount = 0;
+	deferredCount = 0;
+	for (unsigned int i = 0; i < bodyCount; i++)
+	{
+		deferredCount += deferred[i];
+		if (IsMoving(i))
+		{
+			unsigned int root = FindIsland(i);
+			bodyIslands[i] = root == i ? islandCount++ : bodyIslands[root];
+		}
+	}
+
+	//counting sort of the pairs, which keeps them in the same order inside each island
+	islandPairStarts.assign(islandCount + 1, 0);
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		unsigned int a = proxyBodies[pairs[i].a];
+		unsigned int b = proxyBodies[pairs[i].b];
+		islandPairStarts[(IsMoving(a) ? bodyIslands[a] : bodyIslands[b]) + 1]++;
+	}
+	for (int i = 0; i < islandCount; i++)
+	{
+		islandPairStarts[i + 1] += islandPairStarts[i];
+	}
+
+	islandPairs.resize(pairs.size());
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		unsigned int a = proxyBodies[pairs[i].a];
+		unsigned int b = proxyBodies[pairs[i].b];
+		int island = IsMoving(a) ? bodyIslands[a] : bodyIslands[b];
+		islandPairs[islandPairStarts[island]++] = i;
+	}
+
+	//filling moved every start up to the next one's, shift them back
+	for (int i = islandCount; i > 0; i--)
+	{
+		islandPairStarts[i] = islandPairStarts[i - 1];
+	}
+	islandPairStarts[0] = 0;
+
+	//only islands with contacts have anything to solve
+	islandOrder.clear();
+	for (int i = 0; i < islandCount; i++)
+	{
+		if (islandPairStarts[i + 1] > islandPairStarts[i])
+		{
+			islandOrder.push_back(i);
+		}
+	}
+	std::stable_sort(islandOrder.begin(), islandOrder.end(), [this](unsigned int a, unsigned int b)
+	{
+		return islandPairStarts[a + 1] - islandPairStarts[a] > islandPairStarts[b + 1] - islandPairStarts[b];
+	});
+}
+
+//builds every island's contacts (and the collision events), islands don't share moving bodies so they run in parallel
+void PhysicsWorld::FindContacts()
+{
+	int threadCount = threadPool ? threadPool->GetThreadCount() : 1;
+	threadEvents.resize(threadCount);
+	for (int i = 0; i < threadCount; i++)
+	{
+		threadEvents[i].clear();
+	}
+	while (solvers.size() < threadCount)
+	{
+		solvers.push_back(ContactSolver(SolverIterations));
+	}
+
+	//every island writes its contacts over the slice its pairs have in islandPairs
+	contacts.resize(pairs.size());
+	islandContactCounts.assign(islandPairStarts.size() - 1, 0);
+	bodyLevels.resize(positions.size());
+
+	RunTasks((int)islandOrder.size(), [&](int task, int thread)
+	{
+		int island = islandOrder[task];
+		std::vector<PendingEvent>& events = threadEvents[thread];
+		Contact* islandContacts = contacts.data() + islandPairStarts[island];
+		int contactCount = 0;
+
+		for (int k = islandPairStarts[island]; k < islandPairStarts[island + 1]; k++)
+		{
+			unsigned int pair = islandPairs[k];
+			unsigned int a = proxyBodies[pairs[pair].a];
+			unsigned int b = proxyBodies[pairs[pair].b];
+			if (!FindContact(a, b, islandContacts[contactCount]))
+			{
+				continue;
+			}
+			islandContacts[contactCount].id = pair;
+			contactCount++;
+
+			//let whoever is listening know (the gravity example plays a sound)
+			if (reportCollisions[a])
+			{
+				PendingEvent pending;
+				pending.order = pair * 2;
+				pending.event.body = indexToHandle[a];
+				pending.event.other = indexToHandle[b];
+				events.push_back(pending);
+				if (eventQueue != nullptr) eventQueue->Push(pending.event);
+			}
+			if (reportCollisions[b])
+			{
+				PendingEvent pending;
+				pending.order = pair * 2 + 1;
+				pending.event.body = indexToHandle[b];
+				pending.event.other = indexToHandle[a];
+				events.push_back(pending);
+				if (eventQueue != nullptr) eventQueue->Push(pending.event);
+			}
+		}
+
+		islandContactCounts[island] = contactCount;
+	});
+
+	//put the events back in pair list order, which doesn't depend on who found what
+	std::vector<PendingEvent>& allEvents = threadEvents[0];
+	for (int i = 1; i < threadCount; i++)
+	{
+		allEvents.insert(allEvents.end(), threadEvents[i].begin(), threadEvents[i].end());
+	}
+	std::sort(allEvents.begin(), allEvents.end(), [](const PendingEvent& a, const PendingEvent& b)
+	{
+		return a.order < b.order;
+	});
+
+	collisionEvents.clear();
+	for (int i = 0; i < allEvents.size(); i++)
+	{
+		collisionEvents.push_back(allEvents[i].event);
+	}
+}
+
+//every island only touches its own bodies, so they can be solved in any order on any thread
+void PhysicsWorld::SolveIslands()
+{
+	RunTasks((int)islandOrder.size(), [&](int task, int thread)
+	{
+		int island = islandOrder[task];
+		Contact* islandContacts = contacts.data() + islandPairStarts[island];
+		solvers[thread].Solve(islandContacts, islandContactCounts[island], velocities.data(), positions.data(), bodyLevels.data());
+	});
+
+	//remember what the contacts ended up with for next step.
+	//nothing has moved since the step started other than the solver's push out, so previousPositions are where they were found
+	contactCache.NextStep();
+	for (int island = 0; island < islandContactCounts.size(); island++)
+	{
+		for (int k = islandPairStarts[island]; k < islandPairStarts[island] + islandContactCounts[island]; k++)
+		{
+			const Contact& contact = contacts[k];
+			unsigned int a = proxyBodies[pairs[contact.id].a];
+			unsigned int b = proxyBodies[pairs[contact.id].b];
+			unsigned int other = a == contact.a ? b : a;
+			contactCache.Store(indexToHandle[contact.a], indexToHandle[other], contact.normal,
+				previousPositions[other] - previousPositions[contact.a], contact.penetration, contact.impulse);
+		}
+	}
+}
+
+//narrowphase for one pair, the moving body always ends up as a.
+//static bodies are shared between islands, so the solver only ever reads them (as zero velocity, no mass)
+bool PhysicsWorld::FindContact(unsigned int a, unsigned int b, Contact& contact)
+{
+	if (!IsMoving(a))
+	{
+		std::swap(a, b);
+	}
+
+	bool otherMoves = IsMoving(b);
+	unsigned int contactB = otherMoves ? b : ContactSolver::StaticBody;
+	glm::vec3 velocityB = otherMoves ? velocities[b] : glm::vec3(0.f, 0.f, 0.f);
+	float inverseMassB = otherMoves ? GetInverseMass(b) : 0.f;
+	float restitution = std::min(restitutions[a], restitutions[b]);
+
+	//the cache only has contacts that were there last step, from the lower handle's side
+	const CachedContact* cached = contactCache.Find(indexToHandle[a], indexToHandle[b]);
+	float side = indexToHandle[a] < indexToHandle[b] ? 1.f : -1.f;
+
+	//if they haven't moved relative to each other (like a resting pile) the contact is the same as last step's
+	glm::vec3 delta = positions[b] - positions[a];
+	if (cached && glm::all(glm::lessThanEqual(glm::abs(delta - cached->relativePosition * side), glm::vec3(ContactTolerance))))
+	{
+		ContactSolver::BuildContact(a, contactB, cached->normal * side, cached->penetration,
+			velocities[a], GetInverseMass(a), velocityB, inverseMassB, restitution, contact);
+	}
+	else if (!ContactSolver::MakeContact(a, contactB,
+		positions[a], colliders[a], velocities[a], GetInverseMass(a),
+		positions[b], colliders[b], velocityB, inverseMassB,
+		restitution, contact))
+	{
+		return false;
+	}
+
+	//warm start with last step's impulse if it's still pushing the same way
+	if (cached && glm::dot(contact.normal, cached->normal * side) > 0.f)
+	{
+		contact.impulse = cached->impulse;
+	}
+	return true;
+}
+
+//puts whole islands to sleep once every body in them has been resting long enough,
+//a body can't sleep on its own while something on top of it is still moving
+void PhysicsWorld::UpdateSleeping()
+{
+	int islandCount = (int)islandPairStarts.size() - 1;
+	islandRestingSteps.assign(islandCount, StepsToSleep);
+
+	for (unsigned int i = 0; i < positions.size(); i++)
+	{
+		if (IsMoving(i))
+		{
+			bool resting = glm::dot(velocities[i], velocities[i]) < SleepSpeed * SleepSpeed;
+			restingSteps[i] = resting ? restingSteps[i] + 1 : 0;
+			islandRestingSteps[bodyIslands[i]] = std::min(islandRestingSteps[bodyIslands[i]], restingSteps[i]);
+		}
+	}
+
+	for (unsigned int i = 0; i < positions.size(); i++)
+	{
+		if (IsMoving(i) && islandRestingSteps[bodyIslands[i]] >= StepsToSleep)
+		{
+			sleeping[i] = true;
+			velocities[i] = glm::vec3(0.f, 0.f, 0.f);
+		}
+	}
+}
+
+//moves the fast bodies along their path one hit at a time: up to the first thing in the way,
+//bounce off it, then carry on with what's left of the step.
+//only bodies that can't move are swept against, the solver deals with moving ones next step
+void PhysicsWorld::SweepFastBodies()
+{
+	sweepTargets.clear();
+	for (unsigned int i = 0; i < pairs.size(); i++)
+	{
+		unsigned int a = proxyBodies[pairs[i].a];
+		unsigned int b = proxyBodies[pairs[i].b];
+		if (sweeping[a] && !IsMoving(b))
+		{
+			CollisionPair target;
+			target.a = a;
+			target.b = b;
+			sweepTargets.push_back(target);
+		}
+		if (sweeping[b] && !IsMoving(a))
+		{
+			CollisionPair target;
+			target.a = b;
+			target.b = a;
+			sweepTargets.push_back(target);
+		}
+	}
+	std::sort(sweepTargets.begin(), sweepTargets.end(), [](const CollisionPair& x, const CollisionPair& y)
+	{
+		return x.a < y.a || (x.a == y.a && x.b < y.b);
+	});
+
+	unsigned int next = 0;
+	for (unsigned int i = 0; i < positions.size(); i++)
+	{
+		if (!sweeping[i])
+		{
+			continue;
+		}
+
+		unsigned int first = next;
+		while (next < sweepTargets.size() && sweepTargets[next].a == i)
+		{
+			next++;
+		}
+
+		//it might have just gone to sleep
+		if (!IsMoving(i))
+		{
+			continue;
+		}
+
+		glm::vec3 position = positions[i];
+		glm::vec3 velocity = velocities[i];
+		float remaining = pendingScales[i];
+		glm::vec3 lift(0.f, remaining > 0.f ? pendingLifts[i] / remaining : 0.f, 0.f);    //spread over the whole sweep
+		for (int sweepStep = 0; sweepStep < MaxSweepSteps && remaining > 0.f; sweepStep++)
+		{
+			AABB bounds = AABB::FromCenter(position, colliders[i]);
+			glm::vec3 displacement = (velocity + lift) * remaining;
+
+			float firstHit = 1.f;
+			glm::vec3 hitNormal(0.f, 0.f, 0.f);
+			unsigned int hitBody = ContactSolver::StaticBody;
+			for (unsigned int k = first; k < next; k++)
+			{
+				unsigned int other = sweepTargets[k].b;
+				float time;
+				glm::vec3 normal;
+				if (bounds.Sweep(displacement, AABB::FromCenter(positions[other], colliders[other]), time, normal) && time < firstHit)
+				{
+					firstHit = time;
+					hitNormal = normal;
+					hitBody = other;
+				}
+			}
+
+			if (hitBody == ContactSolver::StaticBody)
+			{
+				position += displacement;
+				break;
+			}
+
+			position += displacement * firstHit;
+			remaining *= 1.f - firstHit;
+
+			float approachSpeed = glm::dot(velocity, hitNormal);
+			if (approachSpeed < 0.f)
+			{
+				velocity -= hitNormal * (approachSpeed * (1.f + std::min(restitutions[i], restitutions[hitBody])));
+			}
+
+			if (reportCollisions[i])
+			{
+				CollisionEvent event;
+				event.body = indexToHandle[i];
+				event.other = indexToHandle[hitBody];
+				collisionEvents.push_back(event);
+				if (eventQueue != nullptr) eventQueue->Push(event);
+			}
+			if (reportCollisions[hitBody])
+			{
+				CollisionEvent event;
+				event.body = indexToHandle[hitBody];
+				event.other = indexToHandle[i];
+				collisionEvents.push_back(event);
+				if (eventQueue != nullptr) eventQueue->Push(event);
+			}
+		}
+
+		positions[i] = position;
+		velocities[i] = velocity;
+	}
+}
+
+void PhysicsWorld::Integrate()
+{
+	int count = (int)positions.size();
+	int tasks = GetTaskCount(count);
+	RunTasks(tasks, [&](int task, int thread)
+	{
+		int begin = (int)((long long)count * task / tasks);
+		int end = (int)((long long)count * (task + 1) / tasks);
+		for (int i = begin; i < end; i++)
+		{
+			if (IsMoving(i) && !sweeping[i])
+			{
+				positions[i] += GetPendingDisplacement(i);
+			}
+
+			//whatever wasn't deferred is caught up (sleeping bodies just let the time go)
+			if (!deferred[i])
+			{
+				pendingScales[i] = 0.f;
+				pendingLifts[i] = 0.f;
+			}
+		}
+	});
+}
+
+//finds the root of the body's island, halving the path on the way
+unsigned int PhysicsWorld::FindIsland(unsigned int body)
+{
+	while (islandParents[body] != body)
+	{
+		islandParents[body] = islandParents[islandParents[body]];
+		body = islandParents[body];
+	}
+	return body;
+}
+
+void PhysicsWorld::SetLayersCollide(int layerA, int layerB, bool collide)
+{
+	if (collide)
+	{
+		layerMasks[layerA] |= 1u << layerB;
+		layerMasks[layerB] |= 1u << layerA;
+	}
+	else
+	{
+		layerMasks[layerA] &= ~(1u << layerB);
+		layerMasks[layerB] &= ~(1u << layerA);
+	}
+}
+
+//runs the tasks on the pool, or right here if there isn't one
+void PhysicsWorld::RunTasks(int taskCount, const std::function<void(int task, int thread)>& job)
+{
+	if (threadPool)
+	{
+		threadPool->Run(taskCount, job);
+		return;
+	}
+
+	for (int i = 0; i < taskCount; i++)
+	{
+		job(i, 0);
+	}
+}
+
+//a body that moves less than half its thinnest side per step can't get past anything,
+//even something flat, without overlapping it for at least one step
+bool PhysicsWorld::IsFast(unsigned int index) const
+{
+	glm::vec3 collider = colliders[index];
+	float thinnest = std::min(collider.x, std::min(collider.y, collider.z));
+	glm::vec3 displacement = GetPendingDisplacement(index);
+	return glm::dot(displacement, displacement) > thinnest * thinnest;
+}
+
+//how far the body moves when it's next stepped, with the gravity it banked while deferred
+glm::vec3 PhysicsWorld::GetPendingDisplacement(unsigned int index) const
+{
+	return velocities[index] * pendingScales[index] + glm::vec3(0.f, pendingLifts[index], 0.f);
+}
+
+//splits the per body passes so small scenes stay on one thread
+int PhysicsWorld::GetTaskCount(int count) const
+{
+	int tasks = threadPool ? threadPool->GetThreadCount() * 4 : 1;
+	int maxTasks = std::max(1, count / MinTaskSize);
+	return std::min(tasks, maxTasks);
+}
@@ -0,0 +1,281 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "Broadphase.h"
+#include "ThreadPool.h"
+#include "ContactSolver.h"
+#include "ContactCache.h"
+#include "TagRegistry.h"
+#include "EventQueue.h"
+
+/// <summary>
+/// Sent out when a body that reports collisions hits something
+/// </summary>
+struct CollisionEvent
+{
+	unsigned int body;      //handle of the reporting body
+	unsigned int other;     //handle of what it hit
+};
+
+/// <summary>
+/// How long each part of a step took, in milliseconds
+/// </summary>
+struct StepTimings
+{
+	double broadphase;      //syncing the broadphase and finding the pairs
+	double islands;         //waking bodies up and grouping them into islands
+	double narrowphase;     //turning the pairs into contacts
+	double response;        //solving the contacts, sleeping and sweeping fast bodies
+	double integration;     //gravity and moving everything
+};
+
+/// <summary>
+/// Layers a body can be on, which layers collide is set with PhysicsWorld::SetLayersCollide
+/// </summary>
+enum CollisionLayer
+{
+	LayerDefault = 0,   //things that move around
+	LayerScenery,       //floors and walls
+	LayerDecoration,    //only there to be drawn, never collides (where bodies without a collider go)
+	MaxCollisionLayers = 32
+};
+
+/// <summary>
+/// Owns the physics state of every body as tightly packed arrays (one array per field),
+/// so each pass of the step only streams through the data it actually needs.
+/// Bodies are referred to by handle; handles stay valid while the arrays get shuffled around.
+/// Moving bodies that touch are grouped into islands, and the islands are solved in parallel.
+/// Static bodies are only read while solving, so the result is the same on any number of threads.
+/// Islands that have been resting for a while go to sleep and act like static bodies until something wakes them.
+/// Contacts are remembered between steps, so piles that are still settling start from last step's impulses.
+/// Bodies can be stepped less often than every step (see SetUpdateInterval), they sit out the steps in between like
+/// sleeping bodies and catch up on the time they missed when they're stepped again.
+/// </summary>
+class PhysicsWorld
+{
+private:
+	//body data, all indexed by the same dense index
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> previousPositions;  //positions at the start of the last step, for rendering between steps
+	std::vector<glm::vec3> velocities;
+	std::vector<glm::vec3> colliders;
+	std::vector<float> weights;
+	std::vector<unsigned char> applyPhysics;
+	std::vector<unsigned char> applyGravity;
+	std::vector<unsigned char> sleeping;
+	std::vector<int> restingSteps;              //how many steps in a row the body has barely moved
+	std::vector<unsigned char> reportCollisions;
+	std::vector<float> restitutions;            //how much of the approach speed comes back out of a bounce (0 to 1)
+	std::vector<TagId> tags;
+	std::vector<unsigned char> layers;
+	std::vector<unsigned char> updateIntervals; //the body is only stepped every this many steps
+	std::vector<float> pendingScales;           //BaseTimeSteps since the body was last stepped, its next step covers all of them
+	std::vector<float> pendingLifts;            //how much higher the body ends up than its final velocity alone takes it, from gravity banked while deferred
+	std::vector<unsigned char> deferred;        //sitting this step out
+
+	unsigned int layerMasks[MaxCollisionLayers];    //which layers each layer collides with, as bits
+	TagId floorTag;
+	float stepScale;                            //how many BaseTimeSteps the current step covers
+	unsigned int stepCount;
+	int deferredCount;
+
+	//handle <-> dense index
+	std::vector<unsigned int> handleToIndex;
+	std::vector<unsigned int> indexToHandle;
+	std::vector<unsigned int> freeHandles;
+
+	Broadphase* broadphase;
+	std::vector<BroadphaseProxy> proxies;
+	std::vector<unsigned int> proxyBodies;  //dense index of the body each proxy is for
+	std::vector<CollisionPair> pairs;
+
+	std::vector<CollisionEvent> collisionEvents;
+	EventQueue<CollisionEvent>* eventQueue;     //also gets every event as soon as it's found, if set
+	StepTimings timings;
+
+	//an event along with where it came from in the pair list, so the threads' lists can be put back in order
+	struct PendingEvent
+	{
+		unsigned int order;
+		CollisionEvent event;
+	};
+
+	ThreadPool* threadPool;
+
+	//islands, rebuilt every step
+	std::vector<unsigned int> islandParents;    //union find over the dense body index
+	std::vector<int> bodyIslands;               //island of each moving body
+	std::vector<int> islandPairStarts;          //where each island's pairs start in islandPairs (island count + 1 entries)
+	std::vector<unsigned int> islandPairs;      //pair indices grouped by island, in pair list order
+	std::vector<unsigned int> islandOrder;      //biggest islands first, so they don't end up last on a thread
+	std::vector<int> islandRestingSteps;        //the least any body in the island has been resting
+	std::vector<std::vector<PendingEvent>> threadEvents;
+
+	//contacts, found every step and handed to the solvers
+	std::vector<Contact> contacts;              //each island's contacts start where its pairs do
+	std::vector<int> islandContactCounts;
+	ContactCache contactCache;                  //last steps' contacts, to warm start the solver with
+	std::vector<int> bodyLevels;
+	std::vector<ContactSolver> solvers;         //one per thread
+
+	//fast bodies, found every step
+	std::vector<unsigned char> sweeping;        //moving fast enough this step to be swept instead of just moved
+	std::vector<CollisionPair> sweepTargets;    //(fast body, something it might hit on the way), sorted by fast body
+
+	void DeferBodies();
+	void ApplyGravity();
+	void UpdateBroadphase();
+	void BuildIslands();
+	void FindContacts();
+	void SolveIslands();
+	void UpdateSleeping();
+	bool FindContact(unsigned int a, unsigned int b, Contact& contact);
+	void SweepFastBodies();
+	void Integrate();
+
+	unsigned int FindIsland(unsigned int body);
+
+	bool IsMoving(unsigned int index) const { return applyPhysics[index] && !sleeping[index] && !deferred[index]; }
+	void Wake(unsigned int index) { sleeping[index] = false; restingSteps[index] = 0; }
+	float GetInverseMass(unsigned int index) const { return weights[index] > 0.f ? 1.f / weights[index] : 0.f; }
+	void RunTasks(int taskCount, const std::function<void(int task, int thread)>& job);
+	int GetTaskCount(int count) const;
+	bool IsFast(unsigned int index) const;
+	glm::vec3 GetPendingDisplacement(unsigned int index) const;
+
+public:
+	/// <summary>
+	/// Length of a step (in seconds) everything is tuned for, velocities are in units per BaseTimeStep
+	/// </summary>
+	static const float BaseTimeStep;
+
+	/// <summary>
+	/// Creates an empty world
+	/// </summary>
+	/// <param name="broadphase">Broadphase used to find which bodies need to be checked (not owned)</param>
+	/// <param name="threadPool">Threads to solve the islands on, nullptr runs everything on the calling thread (not owned)</param>
+	/// <param name="arena">Where the contact cache allocates from (not owned, has to outlive the world), nullptr uses the heap</param>
+	PhysicsWorld(Broadphase* broadphase, ThreadPool* threadPool, Arena* arena = nullptr);
+
+	/// <summary>
+	/// Destruction
+	/// </summary>
+	~PhysicsWorld();
+
+	/// <summary>
+	/// Adds a body to the world and returns the handle to it
+	/// </summary>
+	/// <param name="collider">Half size of the collision box, a zero box never collides</param>
+	/// <param name="applyPhysics">Whether the body moves and responds to collisions</param>
+	/// <param name="tag">"Floor" makes the body stop bounces dead, see SetRestitution</param>
+	/// <remarks>Bodies with a zero collider start on LayerDecoration, everything else on LayerDefault</remarks>
+	unsigned int CreateBody(glm::vec3 position, glm::vec3 collider, float weight, bool applyPhysics, TagId tag);
+
+	/// <summary>
+	/// Removes a body, the handle can be given out again afterwards
+	/// </summary>
+	void DestroyBody(unsigned int body);
+
+	/// <summary>
+	/// Advances the simulation by one step: gravity, collisions (island by island), then movement.
+	/// Call it at a fixed rate; longer steps are cheaper, and bodies that would move further than
+	/// their own size in one step are swept along their path so they can't skip through anything
+	/// </summary>
+	/// <param name="timeStep">Length of the step in seconds</param>
+	void Step(float timeStep);
+
+	glm::vec3 GetPosition(unsigned int body) const { return positions[handleToIndex[body]]; }
+	void SetPosition(unsigned int body, glm::vec3 position) { positions[handleToIndex[body]] = position; Wake(handleToIndex[body]); }
+
+	/// <summary>
+	/// Blends from where the body was before the last step to where it is now
+	/// </summary>
+	glm::vec3 GetInterpolatedPosition(unsigned int body, float interpolation) const
+	{
+		unsigned int index = handleToIndex[body];
+		return glm::mix(previousPositions[index], positions[index], interpolation);
+	}
+
+	glm::vec3 GetVelocity(unsigned int body) const { return velocities[handleToIndex[body]]; }
+	void SetVelocity(unsigned int body, glm::vec3 velocity) { velocities[handleToIndex[body]] = velocity; Wake(handleToIndex[body]); }
+
+	glm::vec3 GetCollider(unsigned int body) const { return colliders[handleToIndex[body]]; }
+	float GetWeight(unsigned int body) const { return weights[handleToIndex[body]]; }
+	bool IsPhysicsEnabled(unsigned int body) const { return applyPhysics[handleToIndex[body]] != 0; }
+
+	void SetGravityEnabled(unsigned int body, bool enabled) { applyGravity[handleToIndex[body]] = enabled; }
+
+	/// <summary>
+	/// How bouncy the body is, 0 stops dead and 1 bounces back at full speed. A contact uses the less bouncy of the two
+	/// </summary>
+	void SetRestitution(unsigned int body, float restitution) { restitutions[handleToIndex[body]] = restitution; }
+
+	TagId GetTag(unsigned int body) const { return tags[handleToIndex[body]]; }
+
+	void SetCollisionLayer(unsigned int body, CollisionLayer layer) { layers[handleToIndex[body]] = (unsigned char)layer; }
+	CollisionLayer GetCollisionLayer(unsigned int body) const { return (CollisionLayer)layers[handleToIndex[body]]; }
+
+	/// <summary>
+	/// Sets whether bodies on the two layers collide (both ways). Pairs that don't are dropped by the broadphase
+	/// </summary>
+	void SetLayersCollide(int layerA, int layerB, bool collide);
+
+	/// <summary>
+	/// Collisions with this body will show up in GetCollisionEvents
+	/// </summary>
+	void SetReportCollisions(unsigned int body, bool report) { reportCollisions[handleToIndex[body]] = report; }
+	bool IsReportingCollisions(unsigned int body) const { return reportCollisions[handleToIndex[body]] != 0; }
+
+	/// <summary>
+	/// Adds a force to the body's velocity (and wakes it up)
+	/// </summary>
+	void ApplyForce(unsigned int body, glm::vec3 force) { velocities[handleToIndex[body]] += force; Wake(handleToIndex[body]); }
+
+	/// <summary>
+	/// Only steps the body every interval steps (1 is every step), covering all the time since it was last stepped.
+	/// Bodies with the same interval are spread over the steps in between by handle, so the work is too.
+	/// Anything moving that touches the body brings it into the step early, so they still push on each other both ways,
+	/// but in between it's only swept against like a sleeping body
+	/// </summary>
+	/// <param name="interval">1 to 255</param>
+	void SetUpdateInterval(unsigned int body, int interval) { updateIntervals[handleToIndex[body]] = (unsigned char)std::max(1, std::min(interval, 255)); }
+	int GetUpdateInterval(unsigned int body) const { return updateIntervals[handleToIndex[body]]; }
+
+	/// <summary>
+	/// How many moving bodies sat out the last step
+	/// </summary>
+	int GetDeferredCount() const { return deferredCount; }
+
+	bool IsSleeping(unsigned int body) const { return sleeping[handleToIndex[body]] != 0; }
+	void WakeUp(unsigned int body) { Wake(handleToIndex[body]); }
+
+	/// <summary>
+	/// Every collision from the last step for bodies that report them
+	/// </summary>
+	const std::vector<CollisionEvent>& GetCollisionEvents() const { return collisionEvents; }
+
+	/// <summary>
+	/// Pushes every collision event to the queue as well, straight from whichever thread finds it,
+	/// so whoever reads them (the sound) can drain them once a frame instead of once a step.
+	/// Events come out of the queue in whatever order the threads found them, use GetCollisionEvents when order matters
+	/// </summary>
+	/// <param name="queue">Queue to push to (not owned), nullptr stops pushing</param>
+	void SetEventQueue(EventQueue<CollisionEvent>* queue) { eventQueue = queue; }
+
+	/// <summary>
+	/// How long each part of the last step took
+	/// </summary>
+	const StepTimings& GetStepTimings() const { return timings; }
+
+	/// <summary>
+	/// How many bodies are in the world
+	/// </summary>
+	int GetBodyCount() const { return (int)positions.size(); }
+
+	/// <summary>
+	/// Handle of the index-th body (0 to GetBodyCount), the order changes when bodies are destroyed
+	/// </summary>
+	unsigned int GetBody(int index) const { return indexToHandle[index]; }
+};
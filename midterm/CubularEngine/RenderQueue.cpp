@@ -0,0 +1,153 @@
+#include "RenderQueue.h"
+#include <cstring>
+#include <algorithm>
+#include "GLStateCache.h"
+
+RenderQueue::RenderQueue()
+{
+	viewMatrix = glm::mat4(1.f);
+	duplicates = 0;
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+template <typename T>
+unsigned int RenderQueue::GetId(std::unordered_map<T, unsigned int>& ids, T value)
+{
+	auto found = ids.find(value);
+	if (found != ids.end())
+	{
+		return found->second;
+	}
+
+	//past the last id everything shares it, which only costs some extra state changes
+	unsigned int id = ids.size() < MaxId ? (unsigned int)ids.size() : MaxId;
+	ids[value] = id;
+	return id;
+}
+
+void RenderQueue::Begin(const glm::mat4& viewMatrix)
+{
+	this->viewMatrix = viewMatrix;
+	items.clear();
+	submitted.clear();
+	duplicates = 0;
+}
+
+void RenderQueue::Submit(const void* object, Mesh* mesh, Material* material, const glm::mat4& worldMatrix, glm::vec3 color, float alpha)
+{
+	if (!submitted.insert(object).second)
+	{
+		duplicates++;
+		return;
+	}
+
+	Item item;
+	item.mesh = mesh;
+	item.material = material;
+	item.world = worldMatrix;
+	item.color = glm::vec4(color, alpha);
+	items.push_back(item);
+}
+
+uint64_t RenderQueue::MakeKey(Pass pass, const Item& item)
+{
+	uint64_t program = GetId<GLuint>(programIds, item.material->GetShaderProgram());
+	uint64_t material = GetId<const Material*>(materialIds, item.material);
+	uint64_t mesh = GetId<const Mesh*>(meshIds, item.mesh);
+	uint64_t state = (program << (2 * IdBits)) | (material << IdBits) | mesh;
+
+	//distance in front of the camera (its view is left handed, so in front is +z),
+	//the bits of a positive float sort the same way the float does
+	float depth = std::max(0.f, (viewMatrix * item.world[3]).z);
+	uint32_t depthBits;
+	memcpy(&depthBits, &depth, sizeof(depthBits));
+
+	if (pass == Opaque)
+	{
+		return ((uint64_t)Opaque << 62) | (state << 32) | depthBits;
+	}
+
+	//furthest first, the state only breaks ties
+	return ((uint64_t)Transparent << 62) | ((uint64_t)~depthBits << 30) | state;
+}
+
+void RenderQueue::SortEntries()
+{
+	//least significant byte first, each pass keeps the order of the last one for equal bytes
+	sortScratch.resize(entries.size());
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		int counts[256] = {};
+		for (int i = 0; i < entries.size(); i++)
+		{
+			counts[(entries[i].key >> shift) & 0xFF]++;
+		}
+
+		//every key has the same byte here (like the pass byte on an all opaque frame), nothing would move
+		if (counts[(entries[0].key >> shift) & 0xFF] == entries.size())
+		{
+			continue;
+		}
+
+		int offset = 0;
+		for (int b = 0; b < 256; b++)
+		{
+			int count = counts[b];
+			counts[b] = offset;
+			offset += count;
+		}
+		for (int i = 0; i < entries.size(); i++)
+		{
+			sortScratch[counts[(entries[i].key >> shift) & 0xFF]++] = entries[i];
+		}
+		entries.swap(sortScratch);
+	}
+}
+
+void RenderQueue::Draw(InstanceBatcher* batcher)
+{
+	if (items.empty())
+	{
+		return;
+	}
+
+	entries.resize(items.size());
+	for (int i = 0; i < items.size(); i++)
+	{
+		Pass pass = items[i].color.a < 1.f ? Transparent : Opaque;
+		entries[i].key = MakeKey(pass, items[i]);
+		entries[i].item = i;
+	}
+	SortEntries();
+
+	GLStateCache* state = GLStateCache::GetInstance();
+	int start = 0;
+	while (start < entries.size())
+	{
+		//everything with the same mesh and material in a row goes in one batch
+		const Item& first = items[entries[start].item];
+		bool transparent = (entries[start].key >> 62) == Transparent;
+		int end = start;
+		while (end < entries.size())
+		{
+			const SortEntry& entry = entries[end];
+			const Item& item = items[entry.item];
+			if (item.mesh != first.mesh || item.material != first.material || ((entry.key >> 62) == Transparent) != transparent)
+			{
+				break;
+			}
+			batcher->Add(item.mesh, item.material, item.world, glm::vec3(item.color), item.color.a);
+			end++;
+		}
+
+		state->SetBlending(transparent);
+		batcher->Draw();
+		start = end;
+	}
+
+	//leave it the way the next frame (and anything drawn after) expects
+	state->SetBlending(false);
+}
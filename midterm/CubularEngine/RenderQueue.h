@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include "stdafx.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "InstanceBatcher.h"
+
+/// <summary>
+/// Everything to draw in a frame, sorted so the GL state changes as little as possible between draws.
+/// Each submitted item gets a 64 bit key and the keys are radix sorted once a frame:
+///   opaque:      pass | program | material | mesh | depth (front to back, so the depth test throws more away)
+///   transparent: pass | depth (back to front, so blending comes out right) | program | material | mesh
+/// Opaque things come first. Runs of the same mesh and material in the sorted order go to the
+/// InstanceBatcher as one batch, and everything binds through the GLStateCache
+/// </summary>
+class RenderQueue
+{
+public:
+	enum Pass
+	{
+		Opaque = 0,
+		Transparent = 1
+	};
+
+private:
+	struct Item
+	{
+		Mesh* mesh;
+		Material* material;
+		glm::mat4 world;
+		glm::vec4 color;
+	};
+
+	struct SortEntry
+	{
+		uint64_t key;
+		int item;
+	};
+
+	//program, material and mesh each get 10 bits of the key
+	static const int IdBits = 10;
+	static const unsigned int MaxId = (1 << IdBits) - 1;
+
+	std::vector<Item> items;
+	std::vector<SortEntry> entries;
+	std::vector<SortEntry> sortScratch;   //the other half of each radix pass
+
+	//what's already been submitted this frame, so the same object isn't drawn twice
+	std::unordered_set<const void*> submitted;
+
+	//small ids for the key, handed out the first time each one is seen and kept from then on
+	std::unordered_map<GLuint, unsigned int> programIds;
+	std::unordered_map<const Material*, unsigned int> materialIds;
+	std::unordered_map<const Mesh*, unsigned int> meshIds;
+
+	glm::mat4 viewMatrix;
+
+	int duplicates;
+
+	template <typename T>
+	static unsigned int GetId(std::unordered_map<T, unsigned int>& ids, T value);
+
+	uint64_t MakeKey(Pass pass, const Item& item);
+	void SortEntries();
+
+public:
+	RenderQueue();
+	~RenderQueue();
+
+	/// <summary>
+	/// Empties the queue for a new frame
+	/// </summary>
+	/// <param name="viewMatrix">The camera the frame is drawn with, for sorting by depth</param>
+	void Begin(const glm::mat4& viewMatrix);
+
+	/// <summary>
+	/// Queues something to draw, anything with alpha under 1 goes in the transparent pass
+	/// </summary>
+	/// <param name="object">What's being drawn, a second submit of the same object this frame is dropped</param>
+	/// <param name="worldMatrix">Matrix from model to world space</param>
+	void Submit(const void* object, Mesh* mesh, Material* material, const glm::mat4& worldMatrix, glm::vec3 color, float alpha);
+
+	/// <summary>
+	/// Sorts and draws everything submitted since Begin
+	/// </summary>
+	void Draw(InstanceBatcher* batcher);
+
+	int GetItemCount() const { return (int)items.size(); }
+
+	/// <summary>
+	/// Submits dropped this frame because the object was already in the queue
+	/// </summary>
+	int GetDuplicateCount() const { return duplicates; }
+};
@@ -0,0 +1,447 @@
+#include "Replay.h"
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <iterator>
+#include <algorithm>
+
+//file layout:
+//  header: "CUBR", version, seed (4 bytes), broadphase, keyframe interval
+//  steps:  size of the step, flags, [time step (4 bytes) if it changed], step time (microseconds), body count,
+//          keyframes: every body's handle and state
+//          otherwise: a bit per body for whether it changed, then for each changed body which fields changed,
+//          the velocity changes, how far the position is from where the velocity would have taken it and the new update interval
+//every number is a varint (signed ones zigzagged first), floats are written as their raw bytes
+
+static const char ReplayMagic[4] = { 'C', 'U', 'B', 'R' };
+static const unsigned int ReplayVersion = 2;
+
+static const unsigned char StepKeyframe = 1;
+static const unsigned char StepNewTimeStep = 2;
+
+//which parts of a body changed since the last step (shifted left by the axis)
+static const unsigned char FieldPosition = 1;
+static const unsigned char FieldVelocity = 8;
+static const unsigned char FieldSleeping = 64;
+static const unsigned char FieldInterval = 128;
+
+// ========================================================== writing
+
+static void WriteVarint(std::vector<unsigned char>& out, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+//small negative numbers stay small: 0, -1, 1, -2... become 0, 1, 2, 3...
+static void WriteSigned(std::vector<unsigned char>& out, long long value)
+{
+	WriteVarint(out, ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63));
+}
+
+static void WriteFloat(std::vector<unsigned char>& out, float value)
+{
+	unsigned char bytes[4];
+	memcpy(bytes, &value, 4);
+	out.insert(out.end(), bytes, bytes + 4);
+}
+
+static int Quantize(float value, float precision)
+{
+	double steps = std::floor((double)value / precision + 0.5);
+	if (steps > INT_MAX) return INT_MAX;
+	if (steps < INT_MIN) return INT_MIN;
+	return (int)steps;
+}
+
+//where a body at position (rounded) would be after a step at velocity (rounded), done the same way when reading and writing
+static int PredictPosition(int position, int velocity, float timeStep)
+{
+	double moved = velocity * (double)ReplayVelocityPrecision * (timeStep / PhysicsWorld::BaseTimeStep) / ReplayPositionPrecision;
+	return (int)(position + (long long)std::floor(moved + 0.5));
+}
+
+static void QuantizeBody(const PhysicsWorld* world, unsigned int handle, ReplayBody& body)
+{
+	glm::vec3 position = world->GetPosition(handle);
+	glm::vec3 velocity = world->GetVelocity(handle);
+
+	body.handle = handle;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		body.position[axis] = Quantize(position[axis], ReplayPositionPrecision);
+		body.velocity[axis] = Quantize(velocity[axis], ReplayVelocityPrecision);
+	}
+	body.sleeping = world->IsSleeping(handle);
+	body.updateInterval = (unsigned char)world->GetUpdateInterval(handle);
+}
+
+static bool SameBody(const ReplayBody& a, const ReplayBody& b)
+{
+	return a.handle == b.handle && a.sleeping == b.sleeping && a.updateInterval == b.updateInterval
+		&& memcmp(a.position, b.position, sizeof(a.position)) == 0
+		&& memcmp(a.velocity, b.velocity, sizeof(a.velocity)) == 0;
+}
+
+ReplayRecorder::ReplayRecorder(const std::string& path, unsigned int seed, int broadphase, int keyframeInterval)
+	: file(path, std::ios::binary)
+{
+	this->keyframeInterval = keyframeInterval > 0 ? keyframeInterval : 1;
+	stepCount = 0;
+	byteCount = 0;
+	lastTimeStep = 0.f;
+
+	if (!file.is_open())
+	{
+		return;
+	}
+
+	std::vector<unsigned char> header(ReplayMagic, ReplayMagic + 4);
+	WriteVarint(header, ReplayVersion);
+	header.push_back((unsigned char)seed);
+	header.push_back((unsigned char)(seed >> 8));
+	header.push_back((unsigned char)(seed >> 16));
+	header.push_back((unsigned char)(seed >> 24));
+	WriteVarint(header, broadphase);
+	WriteVarint(header, this->keyframeInterval);
+	file.write((const char*)header.data(), header.size());
+	byteCount += header.size();
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+}
+
+void ReplayRecorder::RecordStep(const PhysicsWorld* world, float timeStep, double stepMilliseconds)
+{
+	if (!file.is_open())
+	{
+		return;
+	}
+
+	int bodyCount = world->GetBodyCount();
+	current.resize(bodyCount);
+	for (int i = 0; i < bodyCount; i++)
+	{
+		QuantizeBody(world, world->GetBody(i), current[i]);
+	}
+
+	//bodies coming or going shuffles everything around, so start over from a keyframe
+	bool keyframe = stepCount % keyframeInterval == 0 || bodyCount != previous.size();
+	for (int i = 0; i < bodyCount && !keyframe; i++)
+	{
+		keyframe = current[i].handle != previous[i].handle;
+	}
+
+	unsigned char flags = 0;
+	if (keyframe) flags |= StepKeyframe;
+	if (stepCount == 0 || timeStep != lastTimeStep) flags |= StepNewTimeStep;
+
+	frame.clear();
+	frame.push_back(flags);
+	if (flags & StepNewTimeStep)
+	{
+		WriteFloat(frame, timeStep);
+	}
+	WriteVarint(frame, (unsigned long long)std::max(0.0, stepMilliseconds * 1000.0 + 0.5));
+	WriteVarint(frame, bodyCount);
+
+	if (keyframe)
+	{
+		for (int i = 0; i < bodyCount; i++)
+		{
+			const ReplayBody& body = current[i];
+			WriteVarint(frame, body.handle);
+			for (int axis = 0; axis < 3; axis++) WriteSigned(frame, body.position[axis]);
+			for (int axis = 0; axis < 3; axis++) WriteSigned(frame, body.velocity[axis]);
+			frame.push_back(body.sleeping);
+			frame.push_back(body.updateInterval);
+		}
+	}
+	else
+	{
+		//which bodies changed, one bit each
+		size_t changedBits = frame.size();
+		frame.resize(frame.size() + (bodyCount + 7) / 8, 0);
+		for (int i = 0; i < bodyCount; i++)
+		{
+			const ReplayBody& body = current[i];
+			const ReplayBody& last = previous[i];
+
+			//most moving bodies just carry on at the speed they're going, so positions are stored as the
+			//difference from where the new velocity would have taken them, which is nothing most of the time
+			int positionDeltas[3];
+			int velocityDeltas[3];
+			unsigned char fields = 0;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				velocityDeltas[axis] = body.velocity[axis] - last.velocity[axis];
+				positionDeltas[axis] = body.position[axis] - PredictPosition(last.position[axis], body.velocity[axis], timeStep);
+				if (positionDeltas[axis] != 0) fields |= FieldPosition << axis;
+				if (velocityDeltas[axis] != 0) fields |= FieldVelocity << axis;
+			}
+			if (body.sleeping != last.sleeping) fields |= FieldSleeping;
+			if (body.updateInterval != last.updateInterval) fields |= FieldInterval;
+
+			if (fields == 0)
+			{
+				continue;
+			}
+			frame[changedBits + i / 8] |= (unsigned char)(1 << (i % 8));
+			frame.push_back(fields);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (fields & (FieldVelocity << axis)) WriteSigned(frame, velocityDeltas[axis]);
+			}
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (fields & (FieldPosition << axis)) WriteSigned(frame, positionDeltas[axis]);
+			}
+			if (fields & FieldInterval) frame.push_back(body.updateInterval);
+		}
+	}
+
+	std::vector<unsigned char> size;
+	WriteVarint(size, frame.size());
+	file.write((const char*)size.data(), size.size());
+	file.write((const char*)frame.data(), frame.size());
+	byteCount += size.size() + frame.size();
+
+	previous.swap(current);
+	lastTimeStep = timeStep;
+	stepCount++;
+}
+
+// ========================================================== reading
+
+//reads from data at offset and moves offset past it, running off the end reads zeros
+static unsigned long long ReadVarint(const std::vector<unsigned char>& data, size_t& offset)
+{
+	unsigned long long value = 0;
+	int shift = 0;
+	while (offset < data.size() && shift < 64)
+	{
+		unsigned char byte = data[offset++];
+		value |= (unsigned long long)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+		{
+			break;
+		}
+		shift += 7;
+	}
+	return value;
+}
+
+static long long ReadSigned(const std::vector<unsigned char>& data, size_t& offset)
+{
+	unsigned long long value = ReadVarint(data, offset);
+	return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+static float ReadFloat(const std::vector<unsigned char>& data, size_t& offset)
+{
+	float value = 0.f;
+	if (offset + 4 <= data.size())
+	{
+		memcpy(&value, &data[offset], 4);
+	}
+	offset += 4;
+	return value;
+}
+
+ReplayPlayer::ReplayPlayer()
+{
+	seed = 0;
+	broadphase = 0;
+	currentStep = -1;
+}
+
+bool ReplayPlayer::Load(const std::string& path)
+{
+	data.clear();
+	steps.clear();
+	bodies.clear();
+	currentStep = -1;
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	if (data.size() < 8 || memcmp(data.data(), ReplayMagic, 4) != 0)
+	{
+		return false;
+	}
+	size_t offset = 4;
+	if (ReadVarint(data, offset) != ReplayVersion || offset + 4 > data.size())
+	{
+		return false;
+	}
+	seed = data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) | ((unsigned int)data[offset + 3] << 24);
+	offset += 4;
+	broadphase = (int)ReadVarint(data, offset);
+	ReadVarint(data, offset);   //keyframe interval, the flags say which steps are keyframes anyway
+
+	//find where every step starts, the bodies are only read when a step is looked at
+	float timeStep = 0.f;
+	while (offset < data.size())
+	{
+		size_t size = (size_t)ReadVarint(data, offset);
+		if (size == 0 || offset + size > data.size())
+		{
+			break;  //cut off part way through writing, keep the steps before it
+		}
+
+		Step step;
+		step.offset = offset;
+		size_t read = offset;
+		unsigned char flags = data[read++];
+		step.keyframe = (flags & StepKeyframe) != 0;
+		if (flags & StepNewTimeStep)
+		{
+			timeStep = ReadFloat(data, read);
+		}
+		step.timeStep = timeStep;
+		step.milliseconds = ReadVarint(data, read) / 1000.0;
+
+		//every step has to be stepped through from a keyframe, a replay that doesn't start with one is useless
+		if (steps.empty() && !step.keyframe)
+		{
+			return false;
+		}
+		steps.push_back(step);
+		offset += size;
+	}
+	return !steps.empty();
+}
+
+void ReplayPlayer::ReadStep(int step)
+{
+	size_t offset = steps[step].offset;
+	unsigned char flags = data[offset++];
+	if (flags & StepNewTimeStep)
+	{
+		offset += 4;
+	}
+	ReadVarint(data, offset);   //step time, already read by Load
+	int bodyCount = (int)ReadVarint(data, offset);
+
+	if (flags & StepKeyframe)
+	{
+		bodies.resize(bodyCount);
+		for (int i = 0; i < bodyCount; i++)
+		{
+			ReplayBody& body = bodies[i];
+			body.handle = (unsigned int)ReadVarint(data, offset);
+			for (int axis = 0; axis < 3; axis++) body.position[axis] = (int)ReadSigned(data, offset);
+			for (int axis = 0; axis < 3; axis++) body.velocity[axis] = (int)ReadSigned(data, offset);
+			body.sleeping = offset < data.size() ? data[offset++] : 0;
+			body.updateInterval = offset < data.size() ? data[offset++] : 1;
+		}
+	}
+	else
+	{
+		//the recorder only writes deltas while the bodies stay the same
+		bodies.resize(bodyCount);
+		size_t changedBits = offset;
+		offset += (bodyCount + 7) / 8;
+		for (int i = 0; i < bodyCount; i++)
+		{
+			//bodies that didn't change still moved along at their velocity
+			ReplayBody& body = bodies[i];
+			unsigned char fields = 0;
+			if ((data[changedBits + i / 8] & (1 << (i % 8))) && offset < data.size())
+			{
+				fields = data[offset++];
+			}
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (fields & (FieldVelocity << axis)) body.velocity[axis] += (int)ReadSigned(data, offset);
+			}
+			for (int axis = 0; axis < 3; axis++)
+			{
+				int delta = fields & (FieldPosition << axis) ? (int)ReadSigned(data, offset) : 0;
+				body.position[axis] = PredictPosition(body.position[axis], body.velocity[axis], steps[step].timeStep) + delta;
+			}
+			if (fields & FieldSleeping) body.sleeping = !body.sleeping;
+			if ((fields & FieldInterval) && offset < data.size()) body.updateInterval = data[offset++];
+		}
+	}
+	currentStep = step;
+}
+
+void ReplayPlayer::Seek(int step)
+{
+	if (step < 0 || step >= (int)steps.size())
+	{
+		return;
+	}
+
+	//step forward from here if there's no keyframe in between, otherwise start from the last keyframe
+	int start = step;
+	while (!steps[start].keyframe)
+	{
+		start--;
+	}
+	if (currentStep >= start && currentStep <= step)
+	{
+		start = currentStep + 1;
+	}
+
+	for (int i = start; i <= step; i++)
+	{
+		ReadStep(i);
+	}
+}
+
+glm::vec3 ReplayPlayer::GetPosition(int index) const
+{
+	const int* position = bodies[index].position;
+	return glm::vec3(position[0], position[1], position[2]) * ReplayPositionPrecision;
+}
+
+glm::vec3 ReplayPlayer::GetVelocity(int index) const
+{
+	const int* velocity = bodies[index].velocity;
+	return glm::vec3(velocity[0], velocity[1], velocity[2]) * ReplayVelocityPrecision;
+}
+
+int ReplayPlayer::FindMismatch(const PhysicsWorld* world) const
+{
+	if (world->GetBodyCount() != bodies.size())
+	{
+		return world->GetBodyCount() > 0 ? (int)world->GetBody(0) : 0;
+	}
+
+	ReplayBody body;
+	for (int i = 0; i < bodies.size(); i++)
+	{
+		QuantizeBody(world, world->GetBody(i), body);
+		if (!SameBody(body, bodies[i]))
+		{
+			return (int)body.handle;
+		}
+	}
+	return -1;
+}
+
+void ReplayPlayer::ApplyUpdateIntervals(PhysicsWorld* world) const
+{
+	//the bodies are recorded in the world's order, so if the counts differ it's already gone wrong
+	if (world->GetBodyCount() != bodies.size())
+	{
+		return;
+	}
+
+	for (int i = 0; i < bodies.size(); i++)
+	{
+		world->SetUpdateInterval(bodies[i].handle, bodies[i].updateInterval);
+	}
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <glm/glm.hpp>
+#include "PhysicsWorld.h"
+
+/// <summary>
+/// One body's state in a replay, rounded to the replay's precision
+/// </summary>
+struct ReplayBody
+{
+	unsigned int handle;
+	int position[3];        //in steps of ReplayPositionPrecision
+	int velocity[3];        //in steps of ReplayVelocityPrecision
+	unsigned char sleeping;
+	unsigned char updateInterval;   //see PhysicsWorld::SetUpdateInterval, needed to simulate the run again
+};
+
+/// <summary>
+/// Smallest change in position a replay keeps (in units)
+/// </summary>
+const float ReplayPositionPrecision = 1.f / 4096.f;
+
+/// <summary>
+/// Smallest change in velocity a replay keeps (in units per PhysicsWorld::BaseTimeStep)
+/// </summary>
+const float ReplayVelocityPrecision = 1.f / 65536.f;
+
+/// <summary>
+/// Writes a run of the simulation to a file as it happens: the seed and broadphase it was started with,
+/// then every step's time step, how long the step took and where every body ended up.
+/// Bodies are stored rounded, and only as the change since the step before (bodies that didn't change
+/// at all cost one bit), with a full keyframe every so often so the replay can be jumped around in.
+/// </summary>
+class ReplayRecorder
+{
+private:
+	std::ofstream file;
+	int keyframeInterval;
+	int stepCount;
+	long long byteCount;
+	float lastTimeStep;
+
+	std::vector<ReplayBody> previous;   //what the last step wrote, the next one is stored relative to it
+	std::vector<ReplayBody> current;
+	std::vector<unsigned char> frame;
+
+public:
+	/// <summary>
+	/// Creates the file and writes the header
+	/// </summary>
+	/// <param name="seed">Seed the scene was created with</param>
+	/// <param name="broadphase">Which broadphase the world uses (as a BroadphaseType), pairs come out in a different order in each one</param>
+	/// <param name="keyframeInterval">Steps between full snapshots, smaller jumps around faster but makes a bigger file</param>
+	ReplayRecorder(const std::string& path, unsigned int seed, int broadphase, int keyframeInterval = 60);
+
+	/// <summary>
+	/// Closes the file
+	/// </summary>
+	~ReplayRecorder();
+
+	bool IsOpen() const { return file.is_open(); }
+
+	/// <summary>
+	/// Adds a step to the replay, call it once the step (and anything else that moves bodies around) is done
+	/// </summary>
+	/// <param name="timeStep">Time step the world was just stepped with</param>
+	/// <param name="stepMilliseconds">How long the step took, so the slow ones can be found later</param>
+	void RecordStep(const PhysicsWorld* world, float timeStep, double stepMilliseconds);
+
+	int GetStepCount() const { return stepCount; }
+	long long GetByteCount() const { return byteCount; }
+};
+
+/// <summary>
+/// Reads a replay written by ReplayRecorder. The whole file is loaded at once, after that any step
+/// can be looked at (starting from the keyframe before it), or the run can be simulated again from its
+/// seed and checked against the recording step by step
+/// </summary>
+class ReplayPlayer
+{
+private:
+	struct Step
+	{
+		size_t offset;      //where the step's data starts in the file
+		bool keyframe;
+		float timeStep;
+		double milliseconds;
+	};
+
+	std::vector<unsigned char> data;
+	std::vector<Step> steps;
+	unsigned int seed;
+	int broadphase;
+
+	std::vector<ReplayBody> bodies;     //state after currentStep
+	int currentStep;
+
+	void ReadStep(int step);
+
+public:
+	/// <summary>
+	/// Creates a player with nothing loaded
+	/// </summary>
+	ReplayPlayer();
+
+	/// <summary>
+	/// Loads a replay, false if the file is missing or isn't one
+	/// </summary>
+	bool Load(const std::string& path);
+
+	unsigned int GetSeed() const { return seed; }
+	int GetBroadphase() const { return broadphase; }
+	int GetStepCount() const { return (int)steps.size(); }
+	float GetTimeStep(int step) const { return steps[step].timeStep; }
+
+	/// <summary>
+	/// How long the step took when it was recorded
+	/// </summary>
+	double GetStepMilliseconds(int step) const { return steps[step].milliseconds; }
+
+	/// <summary>
+	/// Moves to the state after the step, stepping forward from where the player is if it can, otherwise from the keyframe before it
+	/// </summary>
+	void Seek(int step);
+
+	int GetCurrentStep() const { return currentStep; }
+	int GetBodyCount() const { return (int)bodies.size(); }
+	unsigned int GetBody(int index) const { return bodies[index].handle; }
+	glm::vec3 GetPosition(int index) const;
+	glm::vec3 GetVelocity(int index) const;
+	bool IsSleeping(int index) const { return bodies[index].sleeping != 0; }
+
+	/// <summary>
+	/// Gives every body in the world the update interval it had in the current step, call it before stepping
+	/// the world to simulate that step again (the run may have had a SimulationLod changing them)
+	/// </summary>
+	void ApplyUpdateIntervals(PhysicsWorld* world) const;
+
+	/// <summary>
+	/// Compares the world to the current step (after rounding it the same way), for checking a run
+	/// simulated again from the seed still matches the recording
+	/// </summary>
+	/// <returns>Handle of the first body that doesn't match, -1 if everything does</returns>
+	int FindMismatch(const PhysicsWorld* world) const;
+};
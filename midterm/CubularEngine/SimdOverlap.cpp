@@ -0,0 +1,478 @@
+#include "SimdOverlap.h"
+#include <cfloat>
+#include <cmath>
+#include <glm/simd/platform.h>
+
+#if GLM_ARCH & GLM_ARCH_X86_BIT
+#	define SIMD_OVERLAP_X86
+#	include <immintrin.h>
+#	if GLM_COMPILER & GLM_COMPILER_VC
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#endif
+
+//MSVC lets any function use any intrinsic, gcc and clang need to be told which functions are allowed to
+#if defined(SIMD_OVERLAP_X86) && !(GLM_COMPILER & GLM_COMPILER_VC)
+#	define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#	define SIMD_TARGET(isa)
+#endif
+
+//=================================================== batch
+
+AABBBatch::AABBBatch()
+{
+	count = 0;
+	Resize(0);
+}
+
+void AABBBatch::Resize(int count)
+{
+	//empty boxes are inside out, so no comparison against them can pass
+	minX.resize(count + Padding, FLT_MAX);
+	minY.resize(count + Padding, FLT_MAX);
+	minZ.resize(count + Padding, FLT_MAX);
+	maxX.resize(count + Padding, -FLT_MAX);
+	maxY.resize(count + Padding, -FLT_MAX);
+	maxZ.resize(count + Padding, -FLT_MAX);
+
+	//shrinking leaves real boxes behind in the padding, empty them again
+	for (int i = count; i < this->count && i < count + Padding; i++)
+	{
+		Set(i, AABB(glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX)));
+	}
+
+	this->count = count;
+}
+
+void AABBBatch::Add(const AABB& bounds)
+{
+	Resize(count + 1);
+	Set(count - 1, bounds);
+}
+
+void AABBBatch::Set(int index, const AABB& bounds)
+{
+	minX[index] = bounds.min.x;
+	minY[index] = bounds.min.y;
+	minZ[index] = bounds.min.z;
+	maxX[index] = bounds.max.x;
+	maxY[index] = bounds.max.y;
+	maxZ[index] = bounds.max.z;
+}
+
+AABB AABBBatch::Get(int index) const
+{
+	return AABB(glm::vec3(minX[index], minY[index], minZ[index]), glm::vec3(maxX[index], maxY[index], maxZ[index]));
+}
+
+//=================================================== kernels
+
+static inline int CountTrailingZeros(unsigned int mask)
+{
+#if GLM_COMPILER & GLM_COMPILER_VC
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+//turns a mask of overlapping lanes into box indices
+static inline int WriteHits(unsigned int mask, int base, unsigned int* hits, int hitCount)
+{
+	while (mask != 0)
+	{
+		hits[hitCount++] = (unsigned int)(base + CountTrailingZeros(mask));
+		mask &= mask - 1;
+	}
+	return hitCount;
+}
+
+//lanes that are still inside the range, for the last register of a run
+static inline unsigned int GetLaneMask(int remaining, int width)
+{
+	return remaining >= width ? (1u << width) - 1 : (1u << remaining) - 1;
+}
+
+static int FindOverlapsScalar(const AABB& box, const AABBBatch& batch, int begin, int end, unsigned int* hits)
+{
+	const float* minX = batch.GetMinX();
+	const float* minY = batch.GetMinY();
+	const float* minZ = batch.GetMinZ();
+	const float* maxX = batch.GetMaxX();
+	const float* maxY = batch.GetMaxY();
+	const float* maxZ = batch.GetMaxZ();
+
+	int hitCount = 0;
+	for (int i = begin; i < end; i++)
+	{
+		//same test as AABB::Overlaps
+		bool hit = box.min.x <= maxX[i] && box.max.x >= minX[i] &&
+			box.min.y <= maxY[i] && box.max.y >= minY[i] &&
+			box.min.z <= maxZ[i] && box.max.z >= minZ[i];
+
+		hits[hitCount] = (unsigned int)i;
+		hitCount += hit;
+	}
+	return hitCount;
+}
+
+static int CullFrustumScalar(const Frustum& frustum, const AABBBatch& batch, int begin, int end, unsigned int* visible)
+{
+	int visibleCount = 0;
+	for (int i = begin; i < end; i++)
+	{
+		visible[visibleCount] = (unsigned int)i;
+		visibleCount += frustum.Intersects(batch.Get(i));
+	}
+	return visibleCount;
+}
+
+#ifdef SIMD_OVERLAP_X86
+
+SIMD_TARGET("sse2")
+static int FindOverlapsSSE2(const AABB& box, const AABBBatch& batch, int begin, int end, unsigned int* hits)
+{
+	const float* minX = batch.GetMinX();
+	const float* minY = batch.GetMinY();
+	const float* minZ = batch.GetMinZ();
+	const float* maxX = batch.GetMaxX();
+	const float* maxY = batch.GetMaxY();
+	const float* maxZ = batch.GetMaxZ();
+
+	__m128 boxMinX = _mm_set1_ps(box.min.x);
+	__m128 boxMinY = _mm_set1_ps(box.min.y);
+	__m128 boxMinZ = _mm_set1_ps(box.min.z);
+	__m128 boxMaxX = _mm_set1_ps(box.max.x);
+	__m128 boxMaxY = _mm_set1_ps(box.max.y);
+	__m128 boxMaxZ = _mm_set1_ps(box.max.z);
+
+	int hitCount = 0;
+	for (int i = begin; i < end; i += 4)
+	{
+		__m128 hit = _mm_and_ps(_mm_cmple_ps(boxMinX, _mm_loadu_ps(maxX + i)), _mm_cmpge_ps(boxMaxX, _mm_loadu_ps(minX + i)));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(boxMinY, _mm_loadu_ps(maxY + i)), _mm_cmpge_ps(boxMaxY, _mm_loadu_ps(minY + i))));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(boxMinZ, _mm_loadu_ps(maxZ + i)), _mm_cmpge_ps(boxMaxZ, _mm_loadu_ps(minZ + i))));
+
+		unsigned int mask = (unsigned int)_mm_movemask_ps(hit) & GetLaneMask(end - i, 4);
+		hitCount = WriteHits(mask, i, hits, hitCount);
+	}
+	return hitCount;
+}
+
+SIMD_TARGET("avx2")
+static int FindOverlapsAVX2(const AABB& box, const AABBBatch& batch, int begin, int end, unsigned int* hits)
+{
+	const float* minX = batch.GetMinX();
+	const float* minY = batch.GetMinY();
+	const float* minZ = batch.GetMinZ();
+	const float* maxX = batch.GetMaxX();
+	const float* maxY = batch.GetMaxY();
+	const float* maxZ = batch.GetMaxZ();
+
+	__m256 boxMinX = _mm256_set1_ps(box.min.x);
+	__m256 boxMinY = _mm256_set1_ps(box.min.y);
+	__m256 boxMinZ = _mm256_set1_ps(box.min.z);
+	__m256 boxMaxX = _mm256_set1_ps(box.max.x);
+	__m256 boxMaxY = _mm256_set1_ps(box.max.y);
+	__m256 boxMaxZ = _mm256_set1_ps(box.max.z);
+
+	int hitCount = 0;
+	for (int i = begin; i < end; i += 8)
+	{
+		__m256 hit = _mm256_and_ps(_mm256_cmp_ps(boxMinX, _mm256_loadu_ps(maxX + i), _CMP_LE_OQ), _mm256_cmp_ps(boxMaxX, _mm256_loadu_ps(minX + i), _CMP_GE_OQ));
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(boxMinY, _mm256_loadu_ps(maxY + i), _CMP_LE_OQ), _mm256_cmp_ps(boxMaxY, _mm256_loadu_ps(minY + i), _CMP_GE_OQ)));
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(boxMinZ, _mm256_loadu_ps(maxZ + i), _CMP_LE_OQ), _mm256_cmp_ps(boxMaxZ, _mm256_loadu_ps(minZ + i), _CMP_GE_OQ)));
+
+		unsigned int mask = (unsigned int)_mm256_movemask_ps(hit) & GetLaneMask(end - i, 8);
+		hitCount = WriteHits(mask, i, hits, hitCount);
+	}
+	return hitCount;
+}
+
+SIMD_TARGET("avx512f")
+static int FindOverlapsAVX512(const AABB& box, const AABBBatch& batch, int begin, int end, unsigned int* hits)
+{
+	const float* minX = batch.GetMinX();
+	const float* minY = batch.GetMinY();
+	const float* minZ = batch.GetMinZ();
+	const float* maxX = batch.GetMaxX();
+	const float* maxY = batch.GetMaxY();
+	const float* maxZ = batch.GetMaxZ();
+
+	__m512 boxMinX = _mm512_set1_ps(box.min.x);
+	__m512 boxMinY = _mm512_set1_ps(box.min.y);
+	__m512 boxMinZ = _mm512_set1_ps(box.min.z);
+	__m512 boxMaxX = _mm512_set1_ps(box.max.x);
+	__m512 boxMaxY = _mm512_set1_ps(box.max.y);
+	__m512 boxMaxZ = _mm512_set1_ps(box.max.z);
+
+	int hitCount = 0;
+	for (int i = begin; i < end; i += 16)
+	{
+		//every compare only runs on the lanes that passed the ones before
+		__mmask16 mask = (__mmask16)GetLaneMask(end - i, 16);
+		mask = _mm512_mask_cmp_ps_mask(mask, boxMinX, _mm512_loadu_ps(maxX + i), _CMP_LE_OQ);
+		mask = _mm512_mask_cmp_ps_mask(mask, boxMaxX, _mm512_loadu_ps(minX + i), _CMP_GE_OQ);
+		mask = _mm512_mask_cmp_ps_mask(mask, boxMinY, _mm512_loadu_ps(maxY + i), _CMP_LE_OQ);
+		mask = _mm512_mask_cmp_ps_mask(mask, boxMaxY, _mm512_loadu_ps(minY + i), _CMP_GE_OQ);
+		mask = _mm512_mask_cmp_ps_mask(mask, boxMinZ, _mm512_loadu_ps(maxZ + i), _CMP_LE_OQ);
+		mask = _mm512_mask_cmp_ps_mask(mask, boxMaxZ, _mm512_loadu_ps(minZ + i), _CMP_GE_OQ);
+
+		hitCount = WriteHits((unsigned int)mask, i, hits, hitCount);
+	}
+	return hitCount;
+}
+
+//the SIMD cull kernels do the math of Frustum::Intersects in the same order, so they agree with it exactly:
+//a box is outside if (normal . center + w) + (|normal| . extents) < 0 for any plane
+SIMD_TARGET("sse2")
+static int CullFrustumSSE2(const Frustum& frustum, const AABBBatch& batch, int begin, int end, unsigned int* visible)
+{
+	const float* minX = batch.GetMinX();
+	const float* minY = batch.GetMinY();
+	const float* minZ = batch.GetMinZ();
+	const float* maxX = batch.GetMaxX();
+	const float* maxY = batch.GetMaxY();
+	const float* maxZ = batch.GetMaxZ();
+
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 zero = _mm_setzero_ps();
+
+	int visibleCount = 0;
+	for (int i = begin; i < end; i += 4)
+	{
+		__m128 loX = _mm_loadu_ps(minX + i), hiX = _mm_loadu_ps(maxX + i);
+		__m128 loY = _mm_loadu_ps(minY + i), hiY = _mm_loadu_ps(maxY + i);
+		__m128 loZ = _mm_loadu_ps(minZ + i), hiZ = _mm_loadu_ps(maxZ + i);
+		__m128 centerX = _mm_mul_ps(_mm_add_ps(loX, hiX), half);
+		__m128 centerY = _mm_mul_ps(_mm_add_ps(loY, hiY), half);
+		__m128 centerZ = _mm_mul_ps(_mm_add_ps(loZ, hiZ), half);
+		__m128 extentX = _mm_mul_ps(_mm_sub_ps(hiX, loX), half);
+		__m128 extentY = _mm_mul_ps(_mm_sub_ps(hiY, loY), half);
+		__m128 extentZ = _mm_mul_ps(_mm_sub_ps(hiZ, loZ), half);
+
+		unsigned int mask = GetLaneMask(end - i, 4);
+		for (int p = 0; p < 6 && mask != 0; p++)
+		{
+			const glm::vec4& plane = frustum.planes[p];
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(plane.x), centerX),
+				_mm_mul_ps(_mm_set1_ps(plane.y), centerY)),
+				_mm_mul_ps(_mm_set1_ps(plane.z), centerZ)),
+				_mm_set1_ps(plane.w));
+			__m128 radius = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(fabsf(plane.x)), extentX),
+				_mm_mul_ps(_mm_set1_ps(fabsf(plane.y)), extentY)),
+				_mm_mul_ps(_mm_set1_ps(fabsf(plane.z)), extentZ));
+			mask &= (unsigned int)_mm_movemask_ps(_mm_cmpnlt_ps(_mm_add_ps(distance, radius), zero));
+		}
+		visibleCount = WriteHits(mask, i, visible, visibleCount);
+	}
+	return visibleCount;
+}
+
+SIMD_TARGET("avx2")
+static int CullFrustumAVX2(const Frustum& frustum, const AABBBatch& batch, int begin, int end, unsigned int* visible)
+{
+	const float* minX = batch.GetMinX();
+	const float* minY = batch.GetMinY();
+	const float* minZ = batch.GetMinZ();
+	const float* maxX = batch.GetMaxX();
+	const float* maxY = batch.GetMaxY();
+	const float* maxZ = batch.GetMaxZ();
+
+	__m256 half = _mm256_set1_ps(0.5f);
+	__m256 zero = _mm256_setzero_ps();
+
+	int visibleCount = 0;
+	for (int i = begin; i < end; i += 8)
+	{
+		__m256 loX = _mm256_loadu_ps(minX + i), hiX = _mm256_loadu_ps(maxX + i);
+		__m256 loY = _mm256_loadu_ps(minY + i), hiY = _mm256_loadu_ps(maxY + i);
+		__m256 loZ = _mm256_loadu_ps(minZ + i), hiZ = _mm256_loadu_ps(maxZ + i);
+		__m256 centerX = _mm256_mul_ps(_mm256_add_ps(loX, hiX), half);
+		__m256 centerY = _mm256_mul_ps(_mm256_add_ps(loY, hiY), half);
+		__m256 centerZ = _mm256_mul_ps(_mm256_add_ps(loZ, hiZ), half);
+		__m256 extentX = _mm256_mul_ps(_mm256_sub_ps(hiX, loX), half);
+		__m256 extentY = _mm256_mul_ps(_mm256_sub_ps(hiY, loY), half);
+		__m256 extentZ = _mm256_mul_ps(_mm256_sub_ps(hiZ, loZ), half);
+
+		unsigned int mask = GetLaneMask(end - i, 8);
+		for (int p = 0; p < 6 && mask != 0; p++)
+		{
+			const glm::vec4& plane = frustum.planes[p];
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_set1_ps(plane.x), centerX),
+				_mm256_mul_ps(_mm256_set1_ps(plane.y), centerY)),
+				_mm256_mul_ps(_mm256_set1_ps(plane.z), centerZ)),
+				_mm256_set1_ps(plane.w));
+			__m256 radius = _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_set1_ps(fabsf(plane.x)), extentX),
+				_mm256_mul_ps(_mm256_set1_ps(fabsf(plane.y)), extentY)),
+				_mm256_mul_ps(_mm256_set1_ps(fabsf(plane.z)), extentZ));
+			mask &= (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_NLT_UQ));
+		}
+		visibleCount = WriteHits(mask, i, visible, visibleCount);
+	}
+	return visibleCount;
+}
+
+static void CpuId(int leaf, int subleaf, unsigned int regs[4])
+{
+#if GLM_COMPILER & GLM_COMPILER_VC
+	__cpuidex((int*)regs, leaf, subleaf);
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+//which register states the OS saves on a context switch
+static unsigned long long GetEnabledRegisterStates()
+{
+#if GLM_COMPILER & GLM_COMPILER_VC
+	return _xgetbv(0);
+#else
+	unsigned int low, high;
+	__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	return ((unsigned long long)high << 32) | low;
+#endif
+}
+
+#endif //SIMD_OVERLAP_X86
+
+//=================================================== dispatch
+
+typedef int (*OverlapKernel)(const AABB& box, const AABBBatch& batch, int begin, int end, unsigned int* hits);
+typedef int (*CullKernel)(const Frustum& frustum, const AABBBatch& batch, int begin, int end, unsigned int* visible);
+
+static SimdLevel DetectSimdLevel()
+{
+#ifdef SIMD_OVERLAP_X86
+	unsigned int regs[4];
+	CpuId(0, 0, regs);
+	unsigned int maxLeaf = regs[0];
+
+	CpuId(1, 0, regs);
+	bool sse2 = (regs[3] & (1u << 26)) != 0;
+	bool osxsave = (regs[2] & (1u << 27)) != 0;
+	if (!sse2)
+	{
+		return SimdLevel::Scalar;
+	}
+
+	//the wide registers are only usable if the OS saves them
+	bool ymmEnabled = false;
+	bool zmmEnabled = false;
+	if (osxsave)
+	{
+		unsigned long long states = GetEnabledRegisterStates();
+		ymmEnabled = (states & 0x06) == 0x06;
+		zmmEnabled = (states & 0xe6) == 0xe6;
+	}
+
+	if (maxLeaf >= 7)
+	{
+		CpuId(7, 0, regs);
+		bool avx2 = (regs[1] & (1u << 5)) != 0;
+		bool avx512 = (regs[1] & (1u << 16)) != 0;
+
+		if (avx512 && zmmEnabled)
+		{
+			return SimdLevel::AVX512;
+		}
+		if (avx2 && ymmEnabled)
+		{
+			return SimdLevel::AVX2;
+		}
+	}
+	return SimdLevel::SSE2;
+#else
+	return SimdLevel::Scalar;
+#endif
+}
+
+static OverlapKernel GetKernel(SimdLevel level)
+{
+	switch (level)
+	{
+#ifdef SIMD_OVERLAP_X86
+	case SimdLevel::AVX512:
+		return FindOverlapsAVX512;
+	case SimdLevel::AVX2:
+		return FindOverlapsAVX2;
+	case SimdLevel::SSE2:
+		return FindOverlapsSSE2;
+#endif
+	default:
+		return FindOverlapsScalar;
+	}
+}
+
+//culling only goes up to 8 boxes at a time, AVX-512 machines use the AVX2 kernel
+static CullKernel GetCullKernel(SimdLevel level)
+{
+	switch (level)
+	{
+#ifdef SIMD_OVERLAP_X86
+	case SimdLevel::AVX512:
+	case SimdLevel::AVX2:
+		return CullFrustumAVX2;
+	case SimdLevel::SSE2:
+		return CullFrustumSSE2;
+#endif
+	default:
+		return CullFrustumScalar;
+	}
+}
+
+static SimdLevel supportedLevel = DetectSimdLevel();
+static SimdLevel currentLevel = supportedLevel;
+static OverlapKernel currentKernel = GetKernel(currentLevel);
+static CullKernel currentCullKernel = GetCullKernel(currentLevel);
+
+int FindOverlaps(const AABB& box, const AABBBatch& batch, int begin, int end, unsigned int* hits)
+{
+	return currentKernel(box, batch, begin, end, hits);
+}
+
+int CullFrustum(const Frustum& frustum, const AABBBatch& batch, int begin, int end, unsigned int* visible)
+{
+	return currentCullKernel(frustum, batch, begin, end, visible);
+}
+
+SimdLevel GetSupportedSimdLevel()
+{
+	return supportedLevel;
+}
+
+SimdLevel GetSimdLevel()
+{
+	return currentLevel;
+}
+
+void SetSimdLevel(SimdLevel level)
+{
+	currentLevel = level > supportedLevel ? supportedLevel : level;
+	currentKernel = GetKernel(currentLevel);
+	currentCullKernel = GetCullKernel(currentLevel);
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::AVX512:
+		return "AVX-512";
+	case SimdLevel::AVX2:
+		return "AVX2";
+	case SimdLevel::SSE2:
+		return "SSE2";
+	default:
+		return "Scalar";
+	}
+}
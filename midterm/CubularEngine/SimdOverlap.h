@@ -0,0 +1,96 @@
+#pragma once
+#include <vector>
+#include "AABB.h"
+#include "Frustum.h"
+
+/// <summary>
+/// Instruction sets the overlap kernel can run with, from slowest to fastest
+/// </summary>
+enum class SimdLevel
+{
+	Scalar,
+	SSE2,       //4 boxes per test
+	AVX2,       //8 boxes per test
+	AVX512      //16 boxes per test
+};
+
+/// <summary>
+/// A list of boxes stored as one array per coordinate, so a run of them can be loaded straight into a register.
+/// The arrays always have Padding extra empty boxes at the end, so the kernels can read a full register past the last box.
+/// </summary>
+class AABBBatch
+{
+private:
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> minZ;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+	std::vector<float> maxZ;
+	int count;
+
+public:
+	static const int Padding = 16;
+
+	AABBBatch();
+
+	/// <summary>
+	/// Resizes the batch, new boxes are left empty (they never overlap anything)
+	/// </summary>
+	void Resize(int count);
+
+	void Clear() { Resize(0); }
+
+	/// <summary>
+	/// Adds a box to the end of the batch
+	/// </summary>
+	void Add(const AABB& bounds);
+
+	/// <summary>
+	/// Overwrites the box at index
+	/// </summary>
+	void Set(int index, const AABB& bounds);
+
+	AABB Get(int index) const;
+	int GetCount() const { return count; }
+
+	const float* GetMinX() const { return minX.data(); }
+	const float* GetMinY() const { return minY.data(); }
+	const float* GetMinZ() const { return minZ.data(); }
+	const float* GetMaxX() const { return maxX.data(); }
+	const float* GetMaxY() const { return maxY.data(); }
+	const float* GetMaxZ() const { return maxZ.data(); }
+};
+
+/// <summary>
+/// Tests one box against the boxes [begin, end) of the batch, several at a time.
+/// Writes the index of every box that overlaps into hits (which needs room for end - begin entries)
+/// and returns how many there were. Indices come out in increasing order.
+/// </summary>
+int FindOverlaps(const AABB& box, const AABBBatch& batch, int begin, int end, unsigned int* hits);
+
+/// <summary>
+/// Tests the boxes [begin, end) of the batch against a frustum, 4 (SSE2) or 8 (AVX2 and up) at a time,
+/// with the same test as Frustum::Intersects. Writes the index of every box that's at least partly inside
+/// into visible (which needs room for end - begin entries) and returns how many there were, in increasing order.
+/// Runs on the instruction set FindOverlaps is using
+/// </summary>
+int CullFrustum(const Frustum& frustum, const AABBBatch& batch, int begin, int end, unsigned int* visible);
+
+/// <summary>
+/// The best instruction set this CPU and OS can run
+/// </summary>
+SimdLevel GetSupportedSimdLevel();
+
+/// <summary>
+/// The instruction set FindOverlaps is currently using
+/// </summary>
+SimdLevel GetSimdLevel();
+
+/// <summary>
+/// Forces FindOverlaps onto an instruction set (for comparing them), anything the CPU can't run is lowered to what it can.
+/// Not thread safe, call it while nothing is testing boxes
+/// </summary>
+void SetSimdLevel(SimdLevel level);
+
+const char* GetSimdLevelName(SimdLevel level);
@@ -0,0 +1,58 @@
+#include "SimulationLod.h"
+
+SimulationLod::SimulationLod(float nearDistance, float farDistance, int maxInterval)
+{
+	this->nearDistance = nearDistance;
+	this->farDistance = farDistance;
+	this->maxInterval = std::max(1, maxInterval);
+
+	enabled = true;
+	bodiesChanged = 0;
+}
+
+int SimulationLod::GetInterval(float distance, bool inView) const
+{
+	if (!enabled)
+	{
+		return 1;
+	}
+
+	//things just behind the camera can swing into view, so they don't drop as far
+	int interval;
+	if (inView)
+	{
+		interval = distance < nearDistance ? 1 : distance < farDistance ? 2 : 4;
+	}
+	else
+	{
+		interval = distance < nearDistance ? 2 : distance < farDistance ? 4 : 8;
+	}
+	return std::min(interval, maxInterval);
+}
+
+void SimulationLod::Update(PhysicsWorld* world, glm::vec3 viewPosition, const Frustum& view)
+{
+	bodiesChanged = 0;
+	for (int i = 0; i < world->GetBodyCount(); i++)
+	{
+		unsigned int body = world->GetBody(i);
+		if (!world->IsPhysicsEnabled(body))
+		{
+			continue;
+		}
+
+		int interval = 1;
+		if (!world->IsReportingCollisions(body))
+		{
+			glm::vec3 position = world->GetPosition(body);
+			bool inView = view.Intersects(AABB::FromCenter(position, world->GetCollider(body)));
+			interval = GetInterval(glm::length(position - viewPosition), inView);
+		}
+
+		if (world->GetUpdateInterval(body) != interval)
+		{
+			world->SetUpdateInterval(body, interval);
+			bodiesChanged++;
+		}
+	}
+}
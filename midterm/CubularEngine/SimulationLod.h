@@ -0,0 +1,50 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "PhysicsWorld.h"
+#include "Frustum.h"
+
+/// <summary>
+/// Steps bodies the camera can't see well less often, so bigger worlds fit in the same time per frame.
+/// Each body gets an update interval from how far it is from the camera and whether it's in view:
+/// close and in view is every step, further away and out of view up to every maxInterval steps.
+/// Bodies that report collisions always run every step, since they're heard wherever they are
+/// </summary>
+class SimulationLod
+{
+private:
+	float nearDistance;
+	float farDistance;
+	int maxInterval;
+
+	bool enabled;
+	int bodiesChanged;      //how many intervals changed in the last update
+
+public:
+	/// <summary>
+	/// Creates the scheduler, it does nothing until Update is called
+	/// </summary>
+	/// <param name="nearDistance">Bodies closer than this run every step while in view (and every other step behind the camera)</param>
+	/// <param name="farDistance">Bodies further than this run at the lowest rates</param>
+	/// <param name="maxInterval">Steps between updates for the least important bodies</param>
+	SimulationLod(float nearDistance, float farDistance, int maxInterval = 8);
+
+	/// <summary>
+	/// Sets every body's update interval from the camera, call it once a frame before stepping
+	/// </summary>
+	/// <param name="viewPosition">Where the active camera is</param>
+	/// <param name="view">The active camera's frustum</param>
+	void Update(PhysicsWorld* world, glm::vec3 viewPosition, const Frustum& view);
+
+	/// <summary>
+	/// Turning it off puts every body back to every step on the next Update
+	/// </summary>
+	void SetEnabled(bool enabled) { this->enabled = enabled; }
+	bool IsEnabled() const { return enabled; }
+
+	int GetBodiesChanged() const { return bodiesChanged; }
+
+	/// <summary>
+	/// The interval a body at that distance gets, exposed for tools that don't have a camera
+	/// </summary>
+	int GetInterval(float distance, bool inView) const;
+};
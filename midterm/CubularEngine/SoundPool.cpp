@@ -0,0 +1,126 @@
+#include "SoundPool.h"
+
+SoundPool::SoundPool(irrklang::ISoundEngine* engine, int voiceCount)
+{
+	this->engine = engine;
+
+	Voice free;
+	free.sound = nullptr;
+	free.effect = -1;
+	free.started = 0.0;
+	voices.assign(voiceCount > 0 ? voiceCount : 1, free);
+}
+
+SoundPool::~SoundPool()
+{
+	for (int i = 0; i < voices.size(); i++)
+	{
+		if (voices[i].sound != nullptr)
+		{
+			voices[i].sound->stop();
+			Release(voices[i]);
+		}
+	}
+
+	//the sources belong to the engine, it frees them when it's dropped
+}
+
+void SoundPool::Release(Voice& voice)
+{
+	voice.sound->drop();
+	voice.sound = nullptr;
+	voice.effect = -1;
+}
+
+int SoundPool::AddEffect(const char* path, double minInterval, int maxVoices)
+{
+	//loaded into memory right away instead of streamed from disk the first time it plays
+	irrklang::ISoundSource* source = engine->addSoundSourceFromFile(path, irrklang::ESM_NO_STREAMING, true);
+	if (source == nullptr)
+	{
+		return -1;
+	}
+
+	Effect effect;
+	effect.source = source;
+	effect.minInterval = minInterval;
+	effect.maxVoices = maxVoices;
+	effect.lastPlayed = -minInterval;
+	effect.skipped = 0;
+	effects.push_back(effect);
+	return (int)effects.size() - 1;
+}
+
+bool SoundPool::Play(int effect, double time)
+{
+	if (effect < 0 || effect >= effects.size())
+	{
+		return false;
+	}
+
+	Effect& playing = effects[effect];
+	if (time - playing.lastPlayed < playing.minInterval)
+	{
+		playing.skipped++;
+		return false;
+	}
+
+	//a free voice, otherwise the oldest one (but never more than maxVoices of this effect)
+	int voice = -1;
+	int effectVoices = 0;
+	for (int i = 0; i < voices.size(); i++)
+	{
+		if (voices[i].sound == nullptr)
+		{
+			if (voice < 0 || voices[voice].sound != nullptr)
+			{
+				voice = i;
+			}
+			continue;
+		}
+
+		if (voices[i].effect == effect)
+		{
+			effectVoices++;
+		}
+		if (voice < 0 || (voices[voice].sound != nullptr && voices[i].started < voices[voice].started))
+		{
+			voice = i;
+		}
+	}
+	if (effectVoices >= playing.maxVoices)
+	{
+		playing.skipped++;
+		return false;
+	}
+
+	if (voices[voice].sound != nullptr)
+	{
+		voices[voice].sound->stop();
+		Release(voices[voice]);
+	}
+
+	//tracked so the voice can tell when it's done
+	irrklang::ISound* sound = engine->play2D(playing.source, false, false, true);
+	if (sound == nullptr)
+	{
+		return false;
+	}
+
+	voices[voice].sound = sound;
+	voices[voice].effect = effect;
+	voices[voice].started = time;
+	playing.lastPlayed = time;
+	return true;
+}
+
+void SoundPool::Update()
+{
+	for (int i = 0; i < voices.size(); i++)
+	{
+		if (voices[i].sound != nullptr && voices[i].sound->isFinished())
+		{
+			Release(voices[i]);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "stdafx.h"
+
+/// <summary>
+/// Plays short sound effects through a fixed number of voices. Every effect is loaded into memory
+/// once up front, so playing one never touches the disk or looks up a path. Each effect can only
+/// be started so often, and when every voice is busy the oldest one is cut off, so a pile of
+/// simultaneous collisions ends up as a handful of sounds instead of hundreds
+/// </summary>
+class SoundPool
+{
+private:
+	struct Effect
+	{
+		irrklang::ISoundSource* source;
+		double minInterval;     //seconds between starts
+		int maxVoices;          //most voices the effect can have playing at once
+		double lastPlayed;
+		int skipped;            //plays dropped by the limits
+	};
+
+	struct Voice
+	{
+		irrklang::ISound* sound;    //nullptr when the voice is free
+		int effect;
+		double started;
+	};
+
+	irrklang::ISoundEngine* engine;
+	std::vector<Effect> effects;
+	std::vector<Voice> voices;
+
+	void Release(Voice& voice);
+
+public:
+	/// <summary>
+	/// Creates a pool with every voice free
+	/// </summary>
+	/// <param name="engine">Engine the effects play on (not owned)</param>
+	/// <param name="voiceCount">Most effects playing at once</param>
+	SoundPool(irrklang::ISoundEngine* engine, int voiceCount);
+
+	/// <summary>
+	/// Stops everything that's still playing
+	/// </summary>
+	~SoundPool();
+
+	/// <summary>
+	/// Loads an effect into memory and returns its id, -1 if the file couldn't be loaded
+	/// </summary>
+	/// <param name="minInterval">Seconds that have to pass before the effect can be started again</param>
+	/// <param name="maxVoices">Most voices the effect can have playing at once</param>
+	int AddEffect(const char* path, double minInterval, int maxVoices);
+
+	/// <summary>
+	/// Starts an effect if its limits allow it, taking a free voice or cutting off the oldest one
+	/// </summary>
+	/// <param name="time">Current time in seconds, for the rate limit</param>
+	/// <returns>Whether the effect started</returns>
+	bool Play(int effect, double time);
+
+	/// <summary>
+	/// Frees the voices that have finished, call it once a frame
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// How many plays of the effect the limits have dropped
+	/// </summary>
+	int GetSkippedCount(int effect) const { return effects[effect].skipped; }
+};
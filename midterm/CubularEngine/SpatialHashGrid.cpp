@@ -0,0 +1,363 @@
+#include "SpatialHashGrid.h"
+#include <algorithm>
+
+//how many objects one task handles at least, so tiny scenes don't pay for waking threads up
+static const int MinTaskSize = 1024;
+
+SpatialHashGrid::SpatialHashGrid(ThreadPool* threadPool, float cellSize)
+{
+	this->threadPool = threadPool;
+	this->cellSize = cellSize;
+	tableSize = 0;
+	tableMask = 0;
+	largestBucket = 0;
+}
+
+SpatialHashGrid::~SpatialHashGrid()
+{
+}
+
+void SpatialHashGrid::Update(const std::vector<BroadphaseProxy>& proxies)
+{
+	this->proxies = proxies;
+	int count = (int)proxies.size();
+
+	//table at least twice as big as the number of objects keeps the buckets short
+	unsigned int wantedSize = 1024;
+	while (wantedSize < (unsigned int)count * 2)
+	{
+		wantedSize *= 2;
+	}
+	if (wantedSize != tableSize)
+	{
+		tableSize = wantedSize;
+		tableMask = tableSize - 1;
+		cellCounts.reset(new std::atomic<int>[tableSize]);
+		cellStarts.resize(tableSize + 1);
+	}
+
+	cellMins.resize(count);
+	cellMaxs.resize(count);
+	coveredCells.resize(count);
+
+	int objectTasks = GetTaskCount(count);
+	int tableTasks = GetTaskCount((int)tableSize);
+	int tableBlock = ((int)tableSize + tableTasks - 1) / tableTasks;
+	taskLarge.resize(objectTasks);
+	blockSums.resize(tableTasks);
+	blockLargest.resize(tableTasks);
+
+	//1. clear the counts
+	RunTasks(tableTasks, [&](int task, int thread)
+	{
+		int begin = task * tableBlock;
+		int end = std::min(begin + tableBlock, (int)tableSize);
+		for (int k = begin; k < end; k++)
+		{
+			cellCounts[k].store(0, std::memory_order_relaxed);
+		}
+	});
+
+	//2. find the cells every object covers and count how many land in each bucket
+	RunTasks(objectTasks, [&](int task, int thread)
+	{
+		int begin = (int)((long long)count * task / objectTasks);
+		int end = (int)((long long)count * (task + 1) / objectTasks);
+		taskLarge[task].clear();
+
+		for (int i = begin; i < end; i++)
+		{
+			const AABB& bounds = this->proxies[i].bounds;
+			glm::ivec3 low = GetCell(bounds.min);
+			glm::ivec3 high = GetCell(bounds.max);
+			cellMins[i] = low;
+			cellMaxs[i] = high;
+
+			glm::ivec3 span = high - low + 1;
+			long long cells = (long long)span.x * span.y * span.z;
+			if (cells > MaxCellsPerProxy)
+			{
+				coveredCells[i] = 0;
+				taskLarge[task].push_back(i);
+				continue;
+			}
+
+			coveredCells[i] = (int)cells;
+			for (int x = low.x; x <= high.x; x++)
+			{
+				for (int y = low.y; y <= high.y; y++)
+				{
+					for (int z = low.z; z <= high.z; z++)
+					{
+						cellCounts[Hash(glm::ivec3(x, y, z))].fetch_add(1, std::memory_order_relaxed);
+					}
+				}
+			}
+		}
+	});
+
+	largeIds.clear();
+	for (int task = 0; task < objectTasks; task++)
+	{
+		largeIds.insert(largeIds.end(), taskLarge[task].begin(), taskLarge[task].end());
+	}
+
+	largeBounds.Resize((int)largeIds.size());
+	for (int k = 0; k < largeIds.size(); k++)
+	{
+		largeBounds.Set(k, proxies[largeIds[k]].bounds);
+	}
+
+	//3. prefix sum of the counts, each task sums a block then offsets it by the blocks before it
+	RunTasks(tableTasks, [&](int task, int thread)
+	{
+		int begin = task * tableBlock;
+		int end = std::min(begin + tableBlock, (int)tableSize);
+		int sum = 0;
+		int largest = 0;
+		for (int k = begin; k < end; k++)
+		{
+			int cellCount = cellCounts[k].load(std::memory_order_relaxed);
+			sum += cellCount;
+			largest = std::max(largest, cellCount);
+		}
+		blockSums[task] = sum;
+		blockLargest[task] = largest;
+	});
+
+	int total = 0;
+	largestBucket = 0;
+	for (int task = 0; task < tableTasks; task++)
+	{
+		int sum = blockSums[task];
+		blockSums[task] = total;
+		total += sum;
+		largestBucket = std::max(largestBucket, blockLargest[task]);
+	}
+	cellStarts[tableSize] = total;
+	sortedIds.resize(total);
+
+	RunTasks(tableTasks, [&](int task, int thread)
+	{
+		int begin = task * tableBlock;
+		int end = std::min(begin + tableBlock, (int)tableSize);
+		int offset = blockSums[task];
+		for (int k = begin; k < end; k++)
+		{
+			int cellCount = cellCounts[k].load(std::memory_order_relaxed);
+			cellStarts[k] = offset;
+			cellCounts[k].store(offset, std::memory_order_relaxed);  //now the write cursor
+			offset += cellCount;
+		}
+	});
+
+	//4. scatter the ids into their buckets
+	RunTasks(objectTasks, [&](int task, int thread)
+	{
+		int begin = (int)((long long)count * task / objectTasks);
+		int end = (int)((long long)count * (task + 1) / objectTasks);
+		for (int i = begin; i < end; i++)
+		{
+			if (coveredCells[i] == 0)
+			{
+				continue;
+			}
+
+			for (int x = cellMins[i].x; x <= cellMaxs[i].x; x++)
+			{
+				for (int y = cellMins[i].y; y <= cellMaxs[i].y; y++)
+				{
+					for (int z = cellMins[i].z; z <= cellMaxs[i].z; z++)
+					{
+						unsigned int key = Hash(glm::ivec3(x, y, z));
+						sortedIds[cellCounts[key].fetch_add(1, std::memory_order_relaxed)] = i;
+					}
+				}
+			}
+		}
+	});
+
+	//5. the scatter order depends on the threads, sort each bucket so the pairs always come out the same
+	//(this also puts an object next to itself when two of its cells hash to the same bucket)
+	RunTasks(tableTasks, [&](int task, int thread)
+	{
+		int begin = task * tableBlock;
+		int end = std::min(begin + tableBlock, (int)tableSize);
+		for (int k = begin; k < end; k++)
+		{
+			if (cellStarts[k + 1] - cellStarts[k] > 1)
+			{
+				std::sort(sortedIds.begin() + cellStarts[k], sortedIds.begin() + cellStarts[k + 1]);
+			}
+		}
+	});
+
+	//6. copy the bounds out in bucket order, so every bucket can be tested as one batch
+	sortedBounds.Resize(total);
+	int gridTasks = GetTaskCount(total);
+	RunTasks(gridTasks, [&](int task, int thread)
+	{
+		int begin = (int)((long long)total * task / gridTasks);
+		int end = (int)((long long)total * (task + 1) / gridTasks);
+		for (int k = begin; k < end; k++)
+		{
+			sortedBounds.Set(k, this->proxies[sortedIds[k]].bounds);
+		}
+	});
+}
+
+void SpatialHashGrid::FindPairs(std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+
+	int count = (int)proxies.size();
+	int objectTasks = GetTaskCount(count);
+	taskPairs.resize(objectTasks);
+	taskHits.resize(objectTasks);
+	//a scan hits at most a whole bucket or the whole large list, not every object
+	int hitCapacity = std::max(std::max(largestBucket, (int)largeIds.size()), 1);
+	for (int task = 0; task < objectTasks; task++)
+	{
+		taskHits[task].resize(hitCapacity);
+	}
+
+	RunTasks(objectTasks, [&](int task, int thread)
+	{
+		int begin = (int)((long long)count * task / objectTasks);
+		int end = (int)((long long)count * (task + 1) / objectTasks);
+		std::vector<CollisionPair>& out = taskPairs[task];
+		unsigned int* hits = taskHits[task].data();
+		out.clear();
+
+		for (int i = begin; i < end; i++)
+		{
+			const BroadphaseProxy& proxy = proxies[i];
+
+			//static objects don't look for anything, the moving ones find them
+			if (proxy.isStatic)
+			{
+				continue;
+			}
+
+			if (coveredCells[i] > 0)
+			{
+				for (int x = cellMins[i].x; x <= cellMaxs[i].x; x++)
+				{
+					for (int y = cellMins[i].y; y <= cellMaxs[i].y; y++)
+					{
+						for (int z = cellMins[i].z; z <= cellMaxs[i].z; z++)
+						{
+							glm::ivec3 cell(x, y, z);
+							unsigned int bucket = Hash(cell);
+							int bucketStart = cellStarts[bucket];
+							int hitCount = FindOverlaps(proxy.bounds, sortedBounds, bucketStart, cellStarts[bucket + 1], hits);
+							for (int h = 0; h < hitCount; h++)
+							{
+								int entry = (int)hits[h];
+								unsigned int other = sortedIds[entry];
+								const BroadphaseProxy& otherProxy = proxies[other];
+
+								//the same object twice in a bucket, moving pairs are found from both sides (keep the smaller id's)
+								if ((entry > bucketStart && sortedIds[entry - 1] == other) ||
+									other == (unsigned int)i || (!otherProxy.isStatic && other < (unsigned int)i))
+								{
+									continue;
+								}
+
+								//both objects cover the cell where their overlap starts, only that cell keeps the pair
+								if (GetCell(glm::max(proxy.bounds.min, otherProxy.bounds.min)) != cell)
+								{
+									continue;
+								}
+
+								if (ShouldPair(proxy, otherProxy))
+								{
+									CollisionPair pair;
+									pair.a = std::min((unsigned int)i, other);
+									pair.b = std::max((unsigned int)i, other);
+									out.push_back(pair);
+								}
+							}
+						}
+					}
+				}
+
+				//small objects are the ones that check against the big ones
+				int hitCount = FindOverlaps(proxy.bounds, largeBounds, 0, largeBounds.GetCount(), hits);
+				for (int h = 0; h < hitCount; h++)
+				{
+					unsigned int other = largeIds[hits[h]];
+					if (ShouldPair(proxy, proxies[other]))
+					{
+						CollisionPair pair;
+						pair.a = std::min((unsigned int)i, other);
+						pair.b = std::max((unsigned int)i, other);
+						out.push_back(pair);
+					}
+				}
+			}
+			else
+			{
+				//a huge moving object (rare), small moving objects already found it so only check big ones and small static ones
+				for (unsigned int other = 0; other < proxies.size(); other++)
+				{
+					const BroadphaseProxy& otherProxy = proxies[other];
+					bool otherLarge = coveredCells[other] == 0;
+					if (other == (unsigned int)i || (!otherLarge && !otherProxy.isStatic) ||
+						(otherLarge && !otherProxy.isStatic && other < (unsigned int)i))
+					{
+						continue;
+					}
+
+					if (ShouldPair(proxy, otherProxy) && proxy.bounds.Overlaps(otherProxy.bounds))
+					{
+						CollisionPair pair;
+						pair.a = std::min((unsigned int)i, other);
+						pair.b = std::max((unsigned int)i, other);
+						out.push_back(pair);
+					}
+				}
+			}
+		}
+	});
+
+	//join the results in task order, so the list is the same no matter how many threads ran
+	for (int task = 0; task < objectTasks; task++)
+	{
+		pairs.insert(pairs.end(), taskPairs[task].begin(), taskPairs[task].end());
+	}
+}
+
+glm::ivec3 SpatialHashGrid::GetCell(glm::vec3 point) const
+{
+	return glm::ivec3(glm::floor(point / cellSize));
+}
+
+unsigned int SpatialHashGrid::Hash(glm::ivec3 cell) const
+{
+	unsigned int hash = ((unsigned int)cell.x * 73856093u) ^ ((unsigned int)cell.y * 19349663u) ^ ((unsigned int)cell.z * 83492791u);
+	return hash & tableMask;
+}
+
+//runs on the calling thread when there's no pool (a world stepped on a pool thread itself)
+void SpatialHashGrid::RunTasks(int taskCount, const std::function<void(int task, int thread)>& job)
+{
+	if (threadPool)
+	{
+		threadPool->Run(taskCount, job);
+		return;
+	}
+
+	for (int i = 0; i < taskCount; i++)
+	{
+		job(i, 0);
+	}
+}
+
+//splits the work so every thread gets a few tasks (for balancing), but no task is tiny
+int SpatialHashGrid::GetTaskCount(int count) const
+{
+	int tasks = threadPool ? threadPool->GetThreadCount() * 4 : 1;
+	int maxTasks = std::max(1, count / MinTaskSize);
+	return std::min(tasks, maxTasks);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <functional>
+#include "Broadphase.h"
+#include "ThreadPool.h"
+#include "SimdOverlap.h"
+
+/// <summary>
+/// Uniform grid broadphase for lots of similar sized objects. The grid is rebuilt every frame with
+/// a parallel counting sort of every cell each object covers (hashed into a table), then every thread
+/// scans the cells of its share of the objects. A pair is only kept in the cell holding the low corner of
+/// where the two boxes overlap, so objects sharing several cells still pair once.
+/// Objects covering more than MaxCellsPerProxy cells (the floor, walls) are kept out of the grid and checked directly.
+/// Each cell's boxes are also kept side by side in a batch, so an object is tested against a whole cell at once.
+/// </summary>
+class SpatialHashGrid : public Broadphase
+{
+private:
+	ThreadPool* threadPool;
+	float cellSize;
+
+	std::vector<BroadphaseProxy> proxies;
+	std::vector<glm::ivec3> cellMins;           //first and last cell each proxy covers
+	std::vector<glm::ivec3> cellMaxs;
+	std::vector<int> coveredCells;              //how many cells each proxy covers, 0 if it's too big for the grid
+	std::unique_ptr<std::atomic<int>[]> cellCounts;   //also used as the write cursor while scattering
+	std::vector<int> cellStarts;                //where each cell's objects start in sortedIds (table size + 1 entries)
+	std::vector<unsigned int> sortedIds;        //proxy ids ordered by cell, once for each cell they cover
+	std::vector<unsigned int> largeIds;         //proxies too big for the grid
+	AABBBatch sortedBounds;                     //bounds in the same order as sortedIds
+	AABBBatch largeBounds;                      //bounds in the same order as largeIds
+	std::vector<int> blockSums;
+	std::vector<int> blockLargest;
+	int largestBucket;                          //most entries in one bucket, what a cell scan can hit at most
+
+	std::vector<std::vector<unsigned int>> taskLarge;   //per task results, joined in task order
+	std::vector<std::vector<CollisionPair>> taskPairs;
+	std::vector<std::vector<unsigned int>> taskHits;
+
+	unsigned int tableSize;
+	unsigned int tableMask;
+
+	glm::ivec3 GetCell(glm::vec3 point) const;
+	unsigned int Hash(glm::ivec3 cell) const;
+	void RunTasks(int taskCount, const std::function<void(int task, int thread)>& job);
+	int GetTaskCount(int count) const;
+
+public:
+	/// <summary>
+	/// Creates an empty grid
+	/// </summary>
+	/// <param name="threadPool">Threads to build and scan the grid on, nullptr does it all on the calling thread</param>
+	/// <param name="cellSize">Width of a cell, about twice the size of most objects works best</param>
+	SpatialHashGrid(ThreadPool* threadPool, float cellSize);
+
+	/// <summary>
+	/// Destruction
+	/// </summary>
+	~SpatialHashGrid();
+
+	//objects covering more cells than this are checked directly instead
+	static const int MaxCellsPerProxy = 64;
+
+	/// <summary>
+	/// Rebuilds the grid with a parallel counting sort
+	/// </summary>
+	void Update(const std::vector<BroadphaseProxy>& proxies) override;
+
+	/// <summary>
+	/// Scans the cells of every moving object in parallel
+	/// </summary>
+	void FindPairs(std::vector<CollisionPair>& pairs) override;
+};
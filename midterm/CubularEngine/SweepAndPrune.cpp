@@ -0,0 +1,156 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+SweepAndPrune::SweepAndPrune()
+{
+	axis = 0;
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+void SweepAndPrune::Update(const std::vector<BroadphaseProxy>& proxies)
+{
+	bool countChanged = proxies.size() != this->proxies.size();
+	this->proxies = proxies;
+
+	//the set of objects changed, start over with a full sort
+	if (countChanged)
+	{
+		Rebuild();
+		return;
+	}
+
+	//refresh the values, everything is still roughly in the same order as last frame
+	for (int i = 0; i < endpoints.size(); i++)
+	{
+		const AABB& bounds = this->proxies[endpoints[i].GetId()].bounds;
+		endpoints[i].value = endpoints[i].IsMax() ? bounds.max[axis] : bounds.min[axis];
+	}
+
+	//insertion sort, only does work for the endpoints that actually passed each other
+	for (int i = 1; i < endpoints.size(); i++)
+	{
+		Endpoint endpoint = endpoints[i];
+		int j = i - 1;
+		while (j >= 0 && endpoint < endpoints[j])
+		{
+			endpoints[j + 1] = endpoints[j];
+			j--;
+		}
+		endpoints[j + 1] = endpoint;
+	}
+}
+
+void SweepAndPrune::FindPairs(std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+	activeDynamic.clear();
+	activeStatic.clear();
+
+	for (int i = 0; i < endpoints.size(); i++)
+	{
+		unsigned int id = endpoints[i].GetId();
+		const BroadphaseProxy& proxy = proxies[id];
+		std::vector<unsigned int>& active = proxy.isStatic ? activeStatic : activeDynamic;
+
+		//the box ended, take it out of the active list
+		if (endpoints[i].IsMax())
+		{
+			int slot = activeSlot[id];
+			unsigned int last = active.back();
+			active[slot] = last;
+			activeSlot[last] = slot;
+			active.pop_back();
+			continue;
+		}
+
+		//the box started, it overlaps everything active on this axis so check the other two
+		for (int k = 0; k < activeDynamic.size(); k++)
+		{
+			unsigned int other = activeDynamic[k];
+			if (ShouldPair(proxy, proxies[other]) && proxy.bounds.Overlaps(proxies[other].bounds))
+			{
+				CollisionPair pair;
+				pair.a = std::min(id, other);
+				pair.b = std::max(id, other);
+				pairs.push_back(pair);
+			}
+		}
+
+		if (!proxy.isStatic)
+		{
+			for (int k = 0; k < activeStatic.size(); k++)
+			{
+				unsigned int other = activeStatic[k];
+				if (ShouldPair(proxy, proxies[other]) && proxy.bounds.Overlaps(proxies[other].bounds))
+				{
+					CollisionPair pair;
+					pair.a = std::min(id, other);
+					pair.b = std::max(id, other);
+					pairs.push_back(pair);
+				}
+			}
+		}
+
+		activeSlot[id] = (int)active.size();
+		active.push_back(id);
+	}
+}
+
+//builds the endpoint list from scratch
+void SweepAndPrune::Rebuild()
+{
+	axis = ChooseAxis();
+
+	endpoints.resize(proxies.size() * 2);
+	activeSlot.resize(proxies.size());
+	for (unsigned int i = 0; i < proxies.size(); i++)
+	{
+		endpoints[i * 2].value = proxies[i].bounds.min[axis];
+		endpoints[i * 2].data = i << 1;
+		endpoints[i * 2 + 1].value = proxies[i].bounds.max[axis];
+		endpoints[i * 2 + 1].data = (i << 1) | 1;
+	}
+
+	std::sort(endpoints.begin(), endpoints.end());
+}
+
+//sweeps along the axis the objects are the most spread out on, so the fewest boxes overlap on it
+int SweepAndPrune::ChooseAxis() const
+{
+	if (proxies.empty())
+	{
+		return 0;
+	}
+
+	glm::vec3 sum(0.f, 0.f, 0.f);
+	glm::vec3 sumSquared(0.f, 0.f, 0.f);
+	int count = 0;
+	for (int i = 0; i < proxies.size(); i++)
+	{
+		//static objects (like the floor) are usually huge and would throw the spread off
+		if (proxies[i].isStatic)
+		{
+			continue;
+		}
+
+		glm::vec3 center = proxies[i].bounds.GetCenter();
+		sum += center;
+		sumSquared += center * center;
+		count++;
+	}
+
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	glm::vec3 variance = sumSquared / (float)count - (sum / (float)count) * (sum / (float)count);
+	if (variance.x >= variance.y && variance.x >= variance.z)
+	{
+		return 0;
+	}
+	return variance.y >= variance.z ? 1 : 2;
+}
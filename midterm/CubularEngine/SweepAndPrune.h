@@ -0,0 +1,68 @@
+#pragma once
+#include "Broadphase.h"
+
+/// <summary>
+/// Sort and sweep broadphase. The min/max of every box on one axis are kept in a sorted list,
+/// which is fixed up with an insertion sort each frame. Since objects barely move between frames
+/// the list is almost sorted already, so this is close to O(n) for mostly still scenes.
+/// </summary>
+class SweepAndPrune : public Broadphase
+{
+private:
+	/// <summary>
+	/// The min or max of one box on the sweep axis
+	/// </summary>
+	struct Endpoint
+	{
+		float value;
+		unsigned int data;  //proxy id << 1, lowest bit is set for a max endpoint
+
+		unsigned int GetId() const { return data >> 1; }
+		bool IsMax() const { return (data & 1) != 0; }
+
+		//mins go before maxes with the same value, so touching boxes still count as overlapping
+		bool operator<(const Endpoint& other) const
+		{
+			return value < other.value || (value == other.value && (data & 1) < (other.data & 1));
+		}
+	};
+
+	std::vector<Endpoint> endpoints;
+	std::vector<BroadphaseProxy> proxies;
+
+	//proxies the sweep is currently inside of, split so static boxes never get tested against each other
+	std::vector<unsigned int> activeDynamic;
+	std::vector<unsigned int> activeStatic;
+	std::vector<int> activeSlot;    //where each proxy is in its active list, for quick removal
+
+	int axis;
+
+	void Rebuild();
+	int ChooseAxis() const;
+
+public:
+	/// <summary>
+	/// Creates an empty broadphase
+	/// </summary>
+	SweepAndPrune();
+
+	/// <summary>
+	/// Destruction
+	/// </summary>
+	~SweepAndPrune();
+
+	/// <summary>
+	/// Updates the endpoints and insertion sorts them back into order
+	/// </summary>
+	void Update(const std::vector<BroadphaseProxy>& proxies) override;
+
+	/// <summary>
+	/// Sweeps along the sorted axis, every pair is only found once (when the second box starts)
+	/// </summary>
+	void FindPairs(std::vector<CollisionPair>& pairs) override;
+
+	/// <summary>
+	/// The axis being swept (0 = x, 1 = y, 2 = z)
+	/// </summary>
+	int GetAxis() const { return axis; }
+};
@@ -0,0 +1,41 @@
+#include "TagRegistry.h"
+
+//for singleton
+TagRegistry* TagRegistry::instance = nullptr;
+
+TagRegistry::TagRegistry()
+{
+}
+
+TagRegistry::~TagRegistry()
+{
+}
+
+TagRegistry* TagRegistry::GetInstance()
+{
+	if (instance == nullptr)
+	{
+		instance = new TagRegistry();
+	}
+	return instance;
+}
+
+void TagRegistry::Release()
+{
+	delete instance;
+	instance = nullptr;
+}
+
+TagId TagRegistry::Intern(const std::string& tag)
+{
+	auto found = ids.find(tag);
+	if (found != ids.end())
+	{
+		return found->second;
+	}
+
+	TagId id = (TagId)names.size();
+	ids[tag] = id;
+	names.push_back(tag);
+	return id;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/// <summary>
+/// Small number that stands in for a tag string, equal tags always get the same id
+/// </summary>
+typedef unsigned int TagId;
+
+/// <summary>
+/// Singleton that turns tag strings into ids once, so the rest of the code compares numbers instead of strings
+/// </summary>
+class TagRegistry
+{
+private:
+	/// <summary>
+	/// Singleton implementation (private constructor & destructor)
+	/// </summary>
+	TagRegistry();
+	~TagRegistry();
+
+	static TagRegistry* instance;
+
+	std::unordered_map<std::string, TagId> ids;
+	std::vector<std::string> names;     //indexed by id
+
+public:
+	/// <summary>
+	/// Singleton reference to the instance
+	/// </summary>
+	static TagRegistry* GetInstance();
+
+	/// <summary>
+	/// De-allocation
+	/// </summary>
+	static void Release();
+
+	/// <summary>
+	/// Gets the id for a tag, giving it a new one the first time it is seen
+	/// </summary>
+	TagId Intern(const std::string& tag);
+
+	/// <summary>
+	/// Gets the string a tag id was made from
+	/// </summary>
+	const std::string& GetName(TagId tag) const { return names[tag]; }
+};
@@ -0,0 +1,171 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+{
+	if (threadCount <= 0)
+	{
+		threadCount = (int)std::thread::hardware_concurrency();
+	}
+
+	taskRanges.reset(new TaskRange[threadCount]);
+	for (int i = 0; i < threadCount; i++)
+	{
+		taskRanges[i].range = 0;
+	}
+
+	job = nullptr;
+	busyThreads = 0;
+	generation = 0;
+	quit = false;
+
+	//the calling thread is one of the threads, so start one less
+	for (int i = 1; i < threadCount; i++)
+	{
+		threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wakeCondition.notify_all();
+
+	for (int i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+}
+
+void ThreadPool::Run(int taskCount, const std::function<void(int task, int thread)>& job)
+{
+	//not worth waking anyone up
+	if (threads.empty() || taskCount <= 1)
+	{
+		for (int i = 0; i < taskCount; i++)
+		{
+			job(i, 0);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = &job;
+
+		//hand every thread an even slice to start with
+		int threadCount = GetThreadCount();
+		for (int i = 0; i < threadCount; i++)
+		{
+			unsigned long long begin = (unsigned long long)taskCount * i / threadCount;
+			unsigned long long end = (unsigned long long)taskCount * (i + 1) / threadCount;
+			taskRanges[i].range.store(begin | (end << 32));
+		}
+
+		busyThreads = (int)threads.size();
+		generation++;
+	}
+	wakeCondition.notify_all();
+
+	RunTasks(0);
+
+	//wait for the workers to finish what they grabbed
+	std::unique_lock<std::mutex> lock(mutex);
+	doneCondition.wait(lock, [this] { return busyThreads == 0; });
+	this->job = nullptr;
+}
+
+void ThreadPool::WorkerLoop(int thread)
+{
+	unsigned int seenGeneration = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeCondition.wait(lock, [&] { return quit || generation != seenGeneration; });
+			if (quit)
+			{
+				return;
+			}
+			seenGeneration = generation;
+		}
+
+		RunTasks(thread);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			busyThreads--;
+			if (busyThreads == 0)
+			{
+				doneCondition.notify_one();
+			}
+		}
+	}
+}
+
+//runs its own tasks, then steals until every thread is out
+void ThreadPool::RunTasks(int thread)
+{
+	int task;
+	do
+	{
+		while (PopTask(thread, task))
+		{
+			(*job)(task, thread);
+		}
+	} while (StealTasks(thread));
+}
+
+//takes the first task off the thread's own range
+bool ThreadPool::PopTask(int thread, int& task)
+{
+	std::atomic<unsigned long long>& range = taskRanges[thread].range;
+	unsigned long long current = range.load();
+	while (true)
+	{
+		unsigned int begin = (unsigned int)current;
+		unsigned int end = (unsigned int)(current >> 32);
+		if (begin >= end)
+		{
+			return false;
+		}
+
+		if (range.compare_exchange_weak(current, (begin + 1) | ((unsigned long long)end << 32)))
+		{
+			task = (int)begin;
+			return true;
+		}
+	}
+}
+
+//moves the back half of another thread's tasks into this thread's range, false if nobody has any left.
+//a range that still has tasks in it can never come back to an old value, so the compare exchange is safe
+bool ThreadPool::StealTasks(int thread)
+{
+	int threadCount = GetThreadCount();
+	for (int i = 1; i < threadCount; i++)
+	{
+		std::atomic<unsigned long long>& victim = taskRanges[(thread + i) % threadCount].range;
+		unsigned long long current = victim.load();
+		while (true)
+		{
+			unsigned int begin = (unsigned int)current;
+			unsigned int end = (unsigned int)(current >> 32);
+			if (begin >= end)
+			{
+				break;
+			}
+
+			unsigned int split = end - (end - begin + 1) / 2;
+			if (victim.compare_exchange_weak(current, begin | ((unsigned long long)split << 32)))
+			{
+				taskRanges[thread].range.store(split | ((unsigned long long)end << 32));
+				return true;
+			}
+		}
+	}
+	return false;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/// <summary>
+/// A set of worker threads that are kept alive and handed batches of tasks.
+/// The thread that calls Run works on the tasks too, so it counts as thread 0.
+/// Every thread starts with an even share of the tasks, and a thread that runs out steals
+/// half of what is left from another one, so uneven tasks still keep everyone busy.
+/// </summary>
+class ThreadPool
+{
+private:
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wakeCondition;
+	std::condition_variable doneCondition;
+
+	//the tasks a thread still has to run, begin in the low 32 bits and end in the high ones.
+	//the owner takes from the front and thieves take from the back, both with a compare exchange
+	struct alignas(64) TaskRange
+	{
+		std::atomic<unsigned long long> range;
+	};
+	std::unique_ptr<TaskRange[]> taskRanges;
+
+	const std::function<void(int, int)>* job;
+	int busyThreads;
+	unsigned int generation;   //bumped every Run so sleeping workers know there is new work
+	bool quit;
+
+	void WorkerLoop(int thread);
+	void RunTasks(int thread);
+	bool PopTask(int thread, int& task);
+	bool StealTasks(int thread);
+
+public:
+	/// <summary>
+	/// Starts up the worker threads
+	/// </summary>
+	/// <param name="threadCount">Total threads including the caller, 0 uses every core</param>
+	ThreadPool(int threadCount);
+
+	/// <summary>
+	/// Stops and joins every worker
+	/// </summary>
+	~ThreadPool();
+
+	/// <summary>
+	/// Runs job(task, thread) for every task in [0, taskCount), and waits for all of them to finish
+	/// </summary>
+	void Run(int taskCount, const std::function<void(int task, int thread)>& job);
+
+	/// <summary>
+	/// Total number of threads that can run tasks (workers + the caller)
+	/// </summary>
+	int GetThreadCount() const { return (int)threads.size() + 1; }
+};
@@ -0,0 +1,160 @@
+#include "TreeBroadphase.h"
+
+//static objects never move so they get an exact box, moving ones get stretched 2 frames ahead
+TreeBroadphase::TreeBroadphase(float margin)
+	: dynamicTree(margin, 2.f), staticTree(0.f, 0.f)
+{
+}
+
+TreeBroadphase::~TreeBroadphase()
+{
+}
+
+void TreeBroadphase::Update(const std::vector<BroadphaseProxy>& proxies)
+{
+	//proxies were removed from the end of the list
+	while (entries.size() > proxies.size())
+	{
+		Remove((unsigned int)entries.size() - 1);
+		entries.pop_back();
+	}
+
+	size_t oldCount = entries.size();
+	entries.resize(proxies.size());
+	for (size_t i = oldCount; i < proxies.size(); i++)
+	{
+		Add((unsigned int)i, proxies[i]);
+	}
+
+	for (size_t i = 0; i < oldCount; i++)
+	{
+		Entry& entry = entries[i];
+
+		//switched between static and moving, so it needs to change trees
+		if (entry.proxy.isStatic != proxies[i].isStatic)
+		{
+			Remove((unsigned int)i);
+			Add((unsigned int)i, proxies[i]);
+			continue;
+		}
+
+		if (entry.proxy.bounds != proxies[i].bounds)
+		{
+			glm::vec3 displacement = proxies[i].bounds.GetCenter() - entry.proxy.bounds.GetCenter();
+			AABBTree& tree = proxies[i].isStatic ? staticTree : dynamicTree;
+			tree.MoveProxy(entry.treeProxy, proxies[i].bounds, displacement);
+		}
+		entry.proxy = proxies[i];
+	}
+}
+
+void TreeBroadphase::FindPairs(std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+
+	for (unsigned int i = 0; i < entries.size(); i++)
+	{
+		const BroadphaseProxy& proxy = entries[i].proxy;
+		if (proxy.isStatic)
+		{
+			continue;
+		}
+
+		//moving objects see each other from both sides, so only keep the pair from the smaller id
+		candidates.clear();
+		dynamicTree.Query(proxy.bounds, candidates);
+		for (int k = 0; k < candidates.size(); k++)
+		{
+			unsigned int other = candidates[k];
+			if (other > i && ShouldPair(proxy, entries[other].proxy) && proxy.bounds.Overlaps(entries[other].proxy.bounds))
+			{
+				CollisionPair pair;
+				pair.a = i;
+				pair.b = other;
+				pairs.push_back(pair);
+			}
+		}
+
+		candidates.clear();
+		staticTree.Query(proxy.bounds, candidates);
+		for (int k = 0; k < candidates.size(); k++)
+		{
+			unsigned int other = candidates[k];
+			if (ShouldPair(proxy, entries[other].proxy) && proxy.bounds.Overlaps(entries[other].proxy.bounds))
+			{
+				CollisionPair pair;
+				pair.a = glm::min(i, other);
+				pair.b = glm::max(i, other);
+				pairs.push_back(pair);
+			}
+		}
+	}
+}
+
+void TreeBroadphase::Query(const AABB& bounds, std::vector<unsigned int>& results)
+{
+	//the trees give back anything touching the fat boxes, trim it down to the real ones
+	candidates.clear();
+	dynamicTree.Query(bounds, candidates);
+	staticTree.Query(bounds, candidates);
+	for (int k = 0; k < candidates.size(); k++)
+	{
+		if (entries[candidates[k]].proxy.bounds.Overlaps(bounds))
+		{
+			results.push_back(candidates[k]);
+		}
+	}
+}
+
+void TreeBroadphase::QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& results)
+{
+	candidates.clear();
+	dynamicTree.QueryFrustum(frustum, candidates);
+	staticTree.QueryFrustum(frustum, candidates);
+	for (int k = 0; k < candidates.size(); k++)
+	{
+		if (frustum.Intersects(entries[candidates[k]].proxy.bounds))
+		{
+			results.push_back(candidates[k]);
+		}
+	}
+}
+
+bool TreeBroadphase::RayCast(glm::vec3 origin, glm::vec3 direction, float maxDistance, RayHit& hit)
+{
+	//the trees only know about the fat boxes, so test the real box of everything
+	//the ray passes through (the fat box always contains the real one)
+	candidates.clear();
+	dynamicTree.QueryRay(origin, direction, maxDistance, candidates);
+	staticTree.QueryRay(origin, direction, maxDistance, candidates);
+
+	glm::vec3 inverseDirection = 1.f / direction;
+
+	bool found = false;
+	float closest = maxDistance;
+	for (int k = 0; k < candidates.size(); k++)
+	{
+		float distance = AABBTree::RayIntersect(entries[candidates[k]].proxy.bounds, origin, inverseDirection, closest);
+		if (distance >= 0.f)
+		{
+			closest = distance;
+			hit.userData = candidates[k];
+			hit.distance = distance;
+			found = true;
+		}
+	}
+	return found;
+}
+
+void TreeBroadphase::Add(unsigned int id, const BroadphaseProxy& proxy)
+{
+	AABBTree& tree = proxy.isStatic ? staticTree : dynamicTree;
+	entries[id].proxy = proxy;
+	entries[id].treeProxy = tree.CreateProxy(proxy.bounds, id);
+}
+
+void TreeBroadphase::Remove(unsigned int id)
+{
+	AABBTree& tree = entries[id].proxy.isStatic ? staticTree : dynamicTree;
+	tree.DestroyProxy(entries[id].treeProxy);
+}
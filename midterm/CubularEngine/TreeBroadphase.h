@@ -0,0 +1,63 @@
+#pragma once
+#include "Broadphase.h"
+#include "AABBTree.h"
+
+/// <summary>
+/// Broadphase built on two AABBTrees, one for moving objects (with fat boxes) and one for
+/// big static objects like the floor and walls (with exact boxes). Each moving object queries
+/// both trees, so the static ones are only ever checked when something is actually near them.
+/// </summary>
+class TreeBroadphase : public Broadphase
+{
+private:
+	struct Entry
+	{
+		BroadphaseProxy proxy;
+		int treeProxy;      //handle in whichever tree the object is in
+	};
+
+	AABBTree dynamicTree;
+	AABBTree staticTree;
+	std::vector<Entry> entries;
+	std::vector<unsigned int> candidates;
+
+	void Add(unsigned int id, const BroadphaseProxy& proxy);
+	void Remove(unsigned int id);
+
+public:
+	/// <summary>
+	/// Creates an empty broadphase
+	/// </summary>
+	/// <param name="margin">How much bigger than the object each moving box is</param>
+	TreeBroadphase(float margin);
+
+	/// <summary>
+	/// Destruction
+	/// </summary>
+	~TreeBroadphase();
+
+	/// <summary>
+	/// Moves the proxies in the trees (only the ones that left their fat box change the tree)
+	/// </summary>
+	void Update(const std::vector<BroadphaseProxy>& proxies) override;
+
+	/// <summary>
+	/// Queries both trees with each moving object
+	/// </summary>
+	void FindPairs(std::vector<CollisionPair>& pairs) override;
+
+	/// <summary>
+	/// Gets the id of every proxy that overlaps the box
+	/// </summary>
+	void Query(const AABB& bounds, std::vector<unsigned int>& results);
+
+	/// <summary>
+	/// Gets the id of every proxy at least partly inside the frustum
+	/// </summary>
+	void QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& results);
+
+	/// <summary>
+	/// Finds the closest proxy a ray hits (hit.userData is the proxy id)
+	/// </summary>
+	bool RayCast(glm::vec3 origin, glm::vec3 direction, float maxDistance, RayHit& hit);
+};
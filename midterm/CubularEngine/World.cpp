@@ -0,0 +1,28 @@
+#include "World.h"
+
+World::World(BroadphaseType broadphaseType, unsigned int seed, float forceScale, ThreadPool* threadPool)
+{
+	broadphase = CreateBroadphase(broadphaseType, threadPool);
+	physicsWorld = new PhysicsWorld(broadphase, threadPool, &arena);
+	scene = new ExampleScene(physicsWorld, seed, forceScale);
+
+	stepCount = 0;
+	collisionCount = 0;
+}
+
+World::~World()
+{
+	//bodies are removed from the world as the entities are deleted, so it goes after them
+	delete scene;
+	delete physicsWorld;
+	delete broadphase;
+}
+
+void World::Step(float timeStep)
+{
+	physicsWorld->Step(timeStep);
+	scene->Update();
+
+	stepCount++;
+	collisionCount += physicsWorld->GetCollisionEvents().size();
+}
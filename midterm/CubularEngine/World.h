@@ -0,0 +1,56 @@
+#pragma once
+#include "Arena.h"
+#include "ExampleScene.h"
+
+/// <summary>
+/// One copy of the whole simulation: the example scene, the physics world it lives in, its
+/// broadphase and the arena they allocate from. Nothing is shared between worlds (apart from
+/// the tag registry, which is only written while they're being created), so any number of
+/// them can be stepped at the same time on different threads.
+/// Aligned to a cache line so two worlds never share one
+/// </summary>
+class alignas(64) World
+{
+private:
+	Arena arena;
+	Broadphase* broadphase;
+	PhysicsWorld* physicsWorld;
+	ExampleScene* scene;
+
+	int stepCount;
+	long long collisionCount;
+
+public:
+	/// <summary>
+	/// Creates the broadphase, physics world and scene (not thread safe, create worlds one at a time)
+	/// </summary>
+	/// <param name="seed">Seed for the scene's random forces</param>
+	/// <param name="forceScale">Multiplies the scene's random forces</param>
+	/// <param name="threadPool">Threads the world can solve its islands on (not owned), nullptr when the world is stepped on a pool thread itself</param>
+	World(BroadphaseType broadphaseType, unsigned int seed, float forceScale, ThreadPool* threadPool);
+
+	/// <summary>
+	/// Destroys the scene, the physics world and the broadphase
+	/// </summary>
+	~World();
+
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+
+	/// <summary>
+	/// Steps the physics and then moves the examples along
+	/// </summary>
+	/// <param name="timeStep">Length of the step in seconds</param>
+	void Step(float timeStep);
+
+	PhysicsWorld* GetPhysicsWorld() const { return physicsWorld; }
+	ExampleScene* GetScene() const { return scene; }
+	const Arena& GetArena() const { return arena; }
+
+	int GetStepCount() const { return stepCount; }
+
+	/// <summary>
+	/// Collision events reported over every step so far
+	/// </summary>
+	long long GetCollisionCount() const { return collisionCount; }
+};
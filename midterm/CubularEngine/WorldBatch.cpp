@@ -0,0 +1,608 @@
+#include "WorldBatch.h"
+#include <cmath>
+#include <random>
+#include <glm/simd/platform.h>
+#include "ContactSolver.h"
+#include "PhysicsWorld.h"
+#include "SimdOverlap.h"
+
+#if GLM_ARCH & GLM_ARCH_X86_BIT
+#	define WORLD_BATCH_X86
+#	include <immintrin.h>
+#endif
+
+//MSVC lets any function use any intrinsic, gcc and clang need to be told which functions are allowed to
+#if defined(WORLD_BATCH_X86) && !(GLM_COMPILER & GLM_COMPILER_VC)
+#	define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#	define SIMD_TARGET(isa)
+#endif
+
+//same as PhysicsWorld
+static const int SolverIterations = 3;
+
+WorldBatch::WorldBatch(const WorldVariant* variants)
+{
+	for (int lane = 0; lane < WorldBatchLanes; lane++)
+	{
+		this->variants[lane] = variants[lane];
+		gravity.value[lane] = variants[lane].gravity;
+		restitution.value[lane] = variants[lane].restitution;
+	}
+	stepCount = 0;
+	useAvx = false;
+	SetUseAvx(true);
+}
+
+WorldBatch::Lanes WorldBatch::Broadcast(float value)
+{
+	Lanes lanes;
+	for (int lane = 0; lane < WorldBatchLanes; lane++)
+	{
+		lanes.value[lane] = value;
+	}
+	return lanes;
+}
+
+int WorldBatch::AddBody(glm::vec3 position, glm::vec3 collider, float weight, bool applyPhysics, bool floor)
+{
+	colliders.push_back(collider);
+	inverseMasses.push_back(applyPhysics && weight > 0.f ? 1.f / weight : 0.f);
+	floors.push_back(floor);
+
+	positionX.push_back(Broadcast(position.x));
+	positionY.push_back(Broadcast(position.y));
+	positionZ.push_back(Broadcast(position.z));
+	velocityX.push_back(Broadcast(0.f));
+	velocityY.push_back(Broadcast(0.f));
+	velocityZ.push_back(Broadcast(0.f));
+	return (int)colliders.size() - 1;
+}
+
+void WorldBatch::AddKick(int body, float height, glm::vec3 force)
+{
+	Kick kick;
+	kick.body = body;
+	kick.height = height;
+	kick.force = force;
+	kicks.push_back(kick);
+}
+
+void WorldBatch::SetPosition(int body, int lane, glm::vec3 position)
+{
+	positionX[body].value[lane] = position.x;
+	positionY[body].value[lane] = position.y;
+	positionZ[body].value[lane] = position.z;
+}
+
+void WorldBatch::ApplyForce(int body, int lane, glm::vec3 force)
+{
+	if (inverseMasses[body] == 0.f)
+	{
+		return;
+	}
+	velocityX[body].value[lane] += force.x;
+	velocityY[body].value[lane] += force.y;
+	velocityZ[body].value[lane] += force.z;
+}
+
+glm::vec3 WorldBatch::GetPosition(int body, int lane) const
+{
+	return glm::vec3(positionX[body].value[lane], positionY[body].value[lane], positionZ[body].value[lane]);
+}
+
+glm::vec3 WorldBatch::GetVelocity(int body, int lane) const
+{
+	return glm::vec3(velocityX[body].value[lane], velocityY[body].value[lane], velocityZ[body].value[lane]);
+}
+
+void WorldBatch::SetUseAvx(bool use)
+{
+#ifdef WORLD_BATCH_X86
+	//the AVX2 check also makes sure the OS saves the wide registers, the kernels only need AVX
+	useAvx = use && GetSupportedSimdLevel() >= SimdLevel::AVX2;
+#else
+	useAvx = false;
+#endif
+}
+
+void WorldBatch::Step(float timeStep)
+{
+	float stepScale = timeStep / PhysicsWorld::BaseTimeStep;
+
+	//same order as PhysicsWorld::Step
+	if (useAvx)
+	{
+		ApplyGravityAvx(stepScale);
+		FindContactsAvx();
+		SolveContactsAvx();
+		IntegrateAvx(stepScale);
+	}
+	else
+	{
+		ApplyGravityScalar(stepScale);
+		FindContactsScalar();
+		SolveContactsScalar();
+		IntegrateScalar(stepScale);
+	}
+
+	//then the scene's update
+	ApplyKicks();
+	stepCount++;
+}
+
+void WorldBatch::ApplyKicks()
+{
+	for (int i = 0; i < kicks.size(); i++)
+	{
+		const Kick& kick = kicks[i];
+		for (int lane = 0; lane < WorldBatchLanes; lane++)
+		{
+			if (positionY[kick.body].value[lane] <= kick.height)
+			{
+				positionY[kick.body].value[lane] = kick.height;
+				velocityX[kick.body].value[lane] += kick.force.x;
+				velocityY[kick.body].value[lane] += kick.force.y;
+				velocityZ[kick.body].value[lane] += kick.force.z;
+			}
+		}
+	}
+}
+
+//=================================================== a lane at a time
+
+void WorldBatch::ApplyGravityScalar(float stepScale)
+{
+	for (int body = 0; body < colliders.size(); body++)
+	{
+		if (inverseMasses[body] == 0.f)
+		{
+			continue;
+		}
+		for (int lane = 0; lane < WorldBatchLanes; lane++)
+		{
+			velocityY[body].value[lane] -= gravity.value[lane] * stepScale;
+		}
+	}
+}
+
+//same test and contact as ContactSolver::MakeContact and BuildContact
+void WorldBatch::FindContactsScalar()
+{
+	contacts.clear();
+	int bodyCount = (int)colliders.size();
+	for (int a = 0; a < bodyCount; a++)
+	{
+		if (inverseMasses[a] == 0.f)
+		{
+			continue;
+		}
+
+		for (int b = 0; b < bodyCount; b++)
+		{
+			//static bodies are checked from the moving side, moving pairs once
+			bool bStatic = inverseMasses[b] == 0.f;
+			if (b == a || (!bStatic && b < a))
+			{
+				continue;
+			}
+
+			glm::vec3 size = colliders[a] + colliders[b];
+			float normalMass = 1.f / (inverseMasses[a] + inverseMasses[b]);
+			bool bounces = !floors[a] && !floors[b];
+
+			LaneContact contact;
+			bool touching = false;
+			for (int lane = 0; lane < WorldBatchLanes; lane++)
+			{
+				float deltaX = positionX[b].value[lane] - positionX[a].value[lane];
+				float deltaY = positionY[b].value[lane] - positionY[a].value[lane];
+				float deltaZ = positionZ[b].value[lane] - positionZ[a].value[lane];
+				float overlapX = size.x - std::fabs(deltaX);
+				float overlapY = size.y - std::fabs(deltaY);
+				float overlapZ = size.z - std::fabs(deltaZ);
+
+				contact.normalX.value[lane] = 0.f;
+				contact.normalY.value[lane] = 0.f;
+				contact.normalZ.value[lane] = 0.f;
+				contact.penetration.value[lane] = 0.f;
+				contact.normalMass.value[lane] = 0.f;
+				contact.velocityBias.value[lane] = 0.f;
+				contact.impulse.value[lane] = 0.f;
+				if (!(overlapX >= 0.f && overlapY >= 0.f && overlapZ >= 0.f))
+				{
+					continue;
+				}
+				touching = true;
+
+				//push out along the axis that needs the least movement
+				float penetration = overlapX;
+				float normalX = deltaX < 0.f ? -1.f : 1.f;
+				float normalY = 0.f;
+				float normalZ = 0.f;
+				if (overlapY < penetration)
+				{
+					penetration = overlapY;
+					normalX = 0.f;
+					normalY = deltaY < 0.f ? -1.f : 1.f;
+				}
+				if (overlapZ < penetration)
+				{
+					penetration = overlapZ;
+					normalX = 0.f;
+					normalY = 0.f;
+					normalZ = deltaZ < 0.f ? -1.f : 1.f;
+				}
+
+				float velocityBX = bStatic ? 0.f : velocityX[b].value[lane];
+				float velocityBY = bStatic ? 0.f : velocityY[b].value[lane];
+				float velocityBZ = bStatic ? 0.f : velocityZ[b].value[lane];
+				float approachSpeed = ((velocityBX - velocityX[a].value[lane]) * normalX +
+					(velocityBY - velocityY[a].value[lane]) * normalY) +
+					(velocityBZ - velocityZ[a].value[lane]) * normalZ;
+				float laneRestitution = bounces ? restitution.value[lane] : 0.f;
+
+				contact.normalX.value[lane] = normalX;
+				contact.normalY.value[lane] = normalY;
+				contact.normalZ.value[lane] = normalZ;
+				contact.penetration.value[lane] = penetration;
+				contact.normalMass.value[lane] = normalMass;
+				contact.velocityBias.value[lane] = approachSpeed < -ContactSolver::RestitutionThreshold ? -laneRestitution * approachSpeed : 0.f;
+			}
+
+			if (touching)
+			{
+				contact.a = a;
+				contact.b = b;
+				contact.bStatic = bStatic;
+				contacts.push_back(contact);
+			}
+		}
+	}
+}
+
+//same as ContactSolver::SolveVelocities and SolvePositions, without warm starting
+void WorldBatch::SolveContactsScalar()
+{
+	for (int iteration = 0; iteration < SolverIterations; iteration++)
+	{
+		for (int i = 0; i < contacts.size(); i++)
+		{
+			LaneContact& contact = contacts[i];
+			float inverseMassA = inverseMasses[contact.a];
+			float inverseMassB = inverseMasses[contact.b];
+			for (int lane = 0; lane < WorldBatchLanes; lane++)
+			{
+				float velocityBX = contact.bStatic ? 0.f : velocityX[contact.b].value[lane];
+				float velocityBY = contact.bStatic ? 0.f : velocityY[contact.b].value[lane];
+				float velocityBZ = contact.bStatic ? 0.f : velocityZ[contact.b].value[lane];
+				float normalX = contact.normalX.value[lane];
+				float normalY = contact.normalY.value[lane];
+				float normalZ = contact.normalZ.value[lane];
+
+				float vn = ((velocityBX - velocityX[contact.a].value[lane]) * normalX +
+					(velocityBY - velocityY[contact.a].value[lane]) * normalY) +
+					(velocityBZ - velocityZ[contact.a].value[lane]) * normalZ;
+				float lambda = contact.normalMass.value[lane] * (contact.velocityBias.value[lane] - vn);
+				float newImpulse = contact.impulse.value[lane] + lambda;
+				newImpulse = newImpulse > 0.f ? newImpulse : 0.f;
+				lambda = newImpulse - contact.impulse.value[lane];
+				contact.impulse.value[lane] = newImpulse;
+
+				float lambdaA = lambda * inverseMassA;
+				velocityX[contact.a].value[lane] -= normalX * lambdaA;
+				velocityY[contact.a].value[lane] -= normalY * lambdaA;
+				velocityZ[contact.a].value[lane] -= normalZ * lambdaA;
+				if (!contact.bStatic)
+				{
+					float lambdaB = lambda * inverseMassB;
+					velocityX[contact.b].value[lane] += normalX * lambdaB;
+					velocityY[contact.b].value[lane] += normalY * lambdaB;
+					velocityZ[contact.b].value[lane] += normalZ * lambdaB;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < contacts.size(); i++)
+	{
+		const LaneContact& contact = contacts[i];
+		float inverseMassA = inverseMasses[contact.a];
+		float inverseMassB = inverseMasses[contact.b];
+		for (int lane = 0; lane < WorldBatchLanes; lane++)
+		{
+			float excess = contact.penetration.value[lane] - ContactSolver::PenetrationSlop;
+			float correction = (excess > 0.f ? excess : 0.f) * ContactSolver::PositionCorrection * contact.normalMass.value[lane];
+
+			float correctionA = correction * inverseMassA;
+			positionX[contact.a].value[lane] -= contact.normalX.value[lane] * correctionA;
+			positionY[contact.a].value[lane] -= contact.normalY.value[lane] * correctionA;
+			positionZ[contact.a].value[lane] -= contact.normalZ.value[lane] * correctionA;
+			if (!contact.bStatic)
+			{
+				float correctionB = correction * inverseMassB;
+				positionX[contact.b].value[lane] += contact.normalX.value[lane] * correctionB;
+				positionY[contact.b].value[lane] += contact.normalY.value[lane] * correctionB;
+				positionZ[contact.b].value[lane] += contact.normalZ.value[lane] * correctionB;
+			}
+		}
+	}
+}
+
+void WorldBatch::IntegrateScalar(float stepScale)
+{
+	for (int body = 0; body < colliders.size(); body++)
+	{
+		if (inverseMasses[body] == 0.f)
+		{
+			continue;
+		}
+		for (int lane = 0; lane < WorldBatchLanes; lane++)
+		{
+			positionX[body].value[lane] += velocityX[body].value[lane] * stepScale;
+			positionY[body].value[lane] += velocityY[body].value[lane] * stepScale;
+			positionZ[body].value[lane] += velocityZ[body].value[lane] * stepScale;
+		}
+	}
+}
+
+//=================================================== AVX, every lane at once
+
+#ifdef WORLD_BATCH_X86
+
+SIMD_TARGET("avx")
+void WorldBatch::ApplyGravityAvx(float stepScale)
+{
+	__m256 fall = _mm256_mul_ps(_mm256_loadu_ps(gravity.value), _mm256_set1_ps(stepScale));
+	for (int body = 0; body < colliders.size(); body++)
+	{
+		if (inverseMasses[body] == 0.f)
+		{
+			continue;
+		}
+		_mm256_storeu_ps(velocityY[body].value, _mm256_sub_ps(_mm256_loadu_ps(velocityY[body].value), fall));
+	}
+}
+
+SIMD_TARGET("avx")
+void WorldBatch::FindContactsAvx()
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.f);
+	const __m256 minusOne = _mm256_set1_ps(-1.f);
+	const __m256 signBit = _mm256_set1_ps(-0.f);
+	const __m256 threshold = _mm256_set1_ps(-ContactSolver::RestitutionThreshold);
+	const __m256 laneRestitution = _mm256_loadu_ps(restitution.value);
+
+	contacts.clear();
+	int bodyCount = (int)colliders.size();
+	for (int a = 0; a < bodyCount; a++)
+	{
+		if (inverseMasses[a] == 0.f)
+		{
+			continue;
+		}
+
+		__m256 positionAX = _mm256_loadu_ps(positionX[a].value);
+		__m256 positionAY = _mm256_loadu_ps(positionY[a].value);
+		__m256 positionAZ = _mm256_loadu_ps(positionZ[a].value);
+		for (int b = 0; b < bodyCount; b++)
+		{
+			bool bStatic = inverseMasses[b] == 0.f;
+			if (b == a || (!bStatic && b < a))
+			{
+				continue;
+			}
+
+			glm::vec3 size = colliders[a] + colliders[b];
+			__m256 deltaX = _mm256_sub_ps(_mm256_loadu_ps(positionX[b].value), positionAX);
+			__m256 deltaY = _mm256_sub_ps(_mm256_loadu_ps(positionY[b].value), positionAY);
+			__m256 deltaZ = _mm256_sub_ps(_mm256_loadu_ps(positionZ[b].value), positionAZ);
+			__m256 overlapX = _mm256_sub_ps(_mm256_set1_ps(size.x), _mm256_andnot_ps(signBit, deltaX));
+			__m256 overlapY = _mm256_sub_ps(_mm256_set1_ps(size.y), _mm256_andnot_ps(signBit, deltaY));
+			__m256 overlapZ = _mm256_sub_ps(_mm256_set1_ps(size.z), _mm256_andnot_ps(signBit, deltaZ));
+
+			__m256 touching = _mm256_and_ps(_mm256_and_ps(
+				_mm256_cmp_ps(overlapX, zero, _CMP_GE_OQ),
+				_mm256_cmp_ps(overlapY, zero, _CMP_GE_OQ)),
+				_mm256_cmp_ps(overlapZ, zero, _CMP_GE_OQ));
+			if (_mm256_movemask_ps(touching) == 0)
+			{
+				continue;
+			}
+
+			//push out along the axis that needs the least movement
+			__m256 penetration = overlapX;
+			__m256 normalX = _mm256_blendv_ps(one, minusOne, _mm256_cmp_ps(deltaX, zero, _CMP_LT_OQ));
+			__m256 normalY = zero;
+			__m256 normalZ = zero;
+
+			__m256 useY = _mm256_cmp_ps(overlapY, penetration, _CMP_LT_OQ);
+			penetration = _mm256_blendv_ps(penetration, overlapY, useY);
+			normalX = _mm256_blendv_ps(normalX, zero, useY);
+			normalY = _mm256_blendv_ps(zero, _mm256_blendv_ps(one, minusOne, _mm256_cmp_ps(deltaY, zero, _CMP_LT_OQ)), useY);
+
+			__m256 useZ = _mm256_cmp_ps(overlapZ, penetration, _CMP_LT_OQ);
+			penetration = _mm256_blendv_ps(penetration, overlapZ, useZ);
+			normalX = _mm256_blendv_ps(normalX, zero, useZ);
+			normalY = _mm256_blendv_ps(normalY, zero, useZ);
+			normalZ = _mm256_blendv_ps(zero, _mm256_blendv_ps(one, minusOne, _mm256_cmp_ps(deltaZ, zero, _CMP_LT_OQ)), useZ);
+
+			__m256 velocityBX = bStatic ? zero : _mm256_loadu_ps(velocityX[b].value);
+			__m256 velocityBY = bStatic ? zero : _mm256_loadu_ps(velocityY[b].value);
+			__m256 velocityBZ = bStatic ? zero : _mm256_loadu_ps(velocityZ[b].value);
+			__m256 approachSpeed = _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_sub_ps(velocityBX, _mm256_loadu_ps(velocityX[a].value)), normalX),
+				_mm256_mul_ps(_mm256_sub_ps(velocityBY, _mm256_loadu_ps(velocityY[a].value)), normalY)),
+				_mm256_mul_ps(_mm256_sub_ps(velocityBZ, _mm256_loadu_ps(velocityZ[a].value)), normalZ));
+			__m256 bounce = !floors[a] && !floors[b] ? laneRestitution : zero;
+			__m256 velocityBias = _mm256_and_ps(_mm256_cmp_ps(approachSpeed, threshold, _CMP_LT_OQ),
+				_mm256_mul_ps(_mm256_xor_ps(bounce, signBit), approachSpeed));
+
+			//lanes that aren't touching get nothing, so solving them changes nothing
+			LaneContact contact;
+			contact.a = a;
+			contact.b = b;
+			contact.bStatic = bStatic;
+			_mm256_storeu_ps(contact.normalX.value, _mm256_and_ps(touching, normalX));
+			_mm256_storeu_ps(contact.normalY.value, _mm256_and_ps(touching, normalY));
+			_mm256_storeu_ps(contact.normalZ.value, _mm256_and_ps(touching, normalZ));
+			_mm256_storeu_ps(contact.penetration.value, _mm256_and_ps(touching, penetration));
+			_mm256_storeu_ps(contact.normalMass.value, _mm256_and_ps(touching, _mm256_set1_ps(1.f / (inverseMasses[a] + inverseMasses[b]))));
+			_mm256_storeu_ps(contact.velocityBias.value, _mm256_and_ps(touching, velocityBias));
+			_mm256_storeu_ps(contact.impulse.value, zero);
+			contacts.push_back(contact);
+		}
+	}
+}
+
+SIMD_TARGET("avx")
+void WorldBatch::SolveContactsAvx()
+{
+	const __m256 zero = _mm256_setzero_ps();
+
+	for (int iteration = 0; iteration < SolverIterations; iteration++)
+	{
+		for (int i = 0; i < contacts.size(); i++)
+		{
+			LaneContact& contact = contacts[i];
+			__m256 normalX = _mm256_loadu_ps(contact.normalX.value);
+			__m256 normalY = _mm256_loadu_ps(contact.normalY.value);
+			__m256 normalZ = _mm256_loadu_ps(contact.normalZ.value);
+			__m256 velocityAX = _mm256_loadu_ps(velocityX[contact.a].value);
+			__m256 velocityAY = _mm256_loadu_ps(velocityY[contact.a].value);
+			__m256 velocityAZ = _mm256_loadu_ps(velocityZ[contact.a].value);
+			__m256 velocityBX = contact.bStatic ? zero : _mm256_loadu_ps(velocityX[contact.b].value);
+			__m256 velocityBY = contact.bStatic ? zero : _mm256_loadu_ps(velocityY[contact.b].value);
+			__m256 velocityBZ = contact.bStatic ? zero : _mm256_loadu_ps(velocityZ[contact.b].value);
+
+			__m256 vn = _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_sub_ps(velocityBX, velocityAX), normalX),
+				_mm256_mul_ps(_mm256_sub_ps(velocityBY, velocityAY), normalY)),
+				_mm256_mul_ps(_mm256_sub_ps(velocityBZ, velocityAZ), normalZ));
+			__m256 oldImpulse = _mm256_loadu_ps(contact.impulse.value);
+			__m256 lambda = _mm256_mul_ps(_mm256_loadu_ps(contact.normalMass.value), _mm256_sub_ps(_mm256_loadu_ps(contact.velocityBias.value), vn));
+			__m256 newImpulse = _mm256_max_ps(_mm256_add_ps(oldImpulse, lambda), zero);
+			lambda = _mm256_sub_ps(newImpulse, oldImpulse);
+			_mm256_storeu_ps(contact.impulse.value, newImpulse);
+
+			__m256 lambdaA = _mm256_mul_ps(lambda, _mm256_set1_ps(inverseMasses[contact.a]));
+			_mm256_storeu_ps(velocityX[contact.a].value, _mm256_sub_ps(velocityAX, _mm256_mul_ps(normalX, lambdaA)));
+			_mm256_storeu_ps(velocityY[contact.a].value, _mm256_sub_ps(velocityAY, _mm256_mul_ps(normalY, lambdaA)));
+			_mm256_storeu_ps(velocityZ[contact.a].value, _mm256_sub_ps(velocityAZ, _mm256_mul_ps(normalZ, lambdaA)));
+			if (!contact.bStatic)
+			{
+				__m256 lambdaB = _mm256_mul_ps(lambda, _mm256_set1_ps(inverseMasses[contact.b]));
+				_mm256_storeu_ps(velocityX[contact.b].value, _mm256_add_ps(velocityBX, _mm256_mul_ps(normalX, lambdaB)));
+				_mm256_storeu_ps(velocityY[contact.b].value, _mm256_add_ps(velocityBY, _mm256_mul_ps(normalY, lambdaB)));
+				_mm256_storeu_ps(velocityZ[contact.b].value, _mm256_add_ps(velocityBZ, _mm256_mul_ps(normalZ, lambdaB)));
+			}
+		}
+	}
+
+	const __m256 slop = _mm256_set1_ps(ContactSolver::PenetrationSlop);
+	const __m256 positionCorrection = _mm256_set1_ps(ContactSolver::PositionCorrection);
+	for (int i = 0; i < contacts.size(); i++)
+	{
+		const LaneContact& contact = contacts[i];
+		__m256 normalX = _mm256_loadu_ps(contact.normalX.value);
+		__m256 normalY = _mm256_loadu_ps(contact.normalY.value);
+		__m256 normalZ = _mm256_loadu_ps(contact.normalZ.value);
+		__m256 correction = _mm256_mul_ps(_mm256_mul_ps(
+			_mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(contact.penetration.value), slop), zero),
+			positionCorrection), _mm256_loadu_ps(contact.normalMass.value));
+
+		__m256 correctionA = _mm256_mul_ps(correction, _mm256_set1_ps(inverseMasses[contact.a]));
+		_mm256_storeu_ps(positionX[contact.a].value, _mm256_sub_ps(_mm256_loadu_ps(positionX[contact.a].value), _mm256_mul_ps(normalX, correctionA)));
+		_mm256_storeu_ps(positionY[contact.a].value, _mm256_sub_ps(_mm256_loadu_ps(positionY[contact.a].value), _mm256_mul_ps(normalY, correctionA)));
+		_mm256_storeu_ps(positionZ[contact.a].value, _mm256_sub_ps(_mm256_loadu_ps(positionZ[contact.a].value), _mm256_mul_ps(normalZ, correctionA)));
+		if (!contact.bStatic)
+		{
+			__m256 correctionB = _mm256_mul_ps(correction, _mm256_set1_ps(inverseMasses[contact.b]));
+			_mm256_storeu_ps(positionX[contact.b].value, _mm256_add_ps(_mm256_loadu_ps(positionX[contact.b].value), _mm256_mul_ps(normalX, correctionB)));
+			_mm256_storeu_ps(positionY[contact.b].value, _mm256_add_ps(_mm256_loadu_ps(positionY[contact.b].value), _mm256_mul_ps(normalY, correctionB)));
+			_mm256_storeu_ps(positionZ[contact.b].value, _mm256_add_ps(_mm256_loadu_ps(positionZ[contact.b].value), _mm256_mul_ps(normalZ, correctionB)));
+		}
+	}
+}
+
+SIMD_TARGET("avx")
+void WorldBatch::IntegrateAvx(float stepScale)
+{
+	__m256 scale = _mm256_set1_ps(stepScale);
+	for (int body = 0; body < colliders.size(); body++)
+	{
+		if (inverseMasses[body] == 0.f)
+		{
+			continue;
+		}
+		_mm256_storeu_ps(positionX[body].value, _mm256_add_ps(_mm256_loadu_ps(positionX[body].value), _mm256_mul_ps(_mm256_loadu_ps(velocityX[body].value), scale)));
+		_mm256_storeu_ps(positionY[body].value, _mm256_add_ps(_mm256_loadu_ps(positionY[body].value), _mm256_mul_ps(_mm256_loadu_ps(velocityY[body].value), scale)));
+		_mm256_storeu_ps(positionZ[body].value, _mm256_add_ps(_mm256_loadu_ps(positionZ[body].value), _mm256_mul_ps(_mm256_loadu_ps(velocityZ[body].value), scale)));
+	}
+}
+
+#else
+
+//never picked without x86, SetUseAvx keeps useAvx off
+void WorldBatch::ApplyGravityAvx(float stepScale) { ApplyGravityScalar(stepScale); }
+void WorldBatch::FindContactsAvx() { FindContactsScalar(); }
+void WorldBatch::SolveContactsAvx() { SolveContactsScalar(); }
+void WorldBatch::IntegrateAvx(float stepScale) { IntegrateScalar(stepScale); }
+
+#endif
+
+//=================================================== scenes
+
+//the same numbers ExampleScene::RandomRange gives for the same seed
+static float RandomRange(std::mt19937& random, float min, float max)
+{
+	return min + (max - min) * (float)(random() / 4294967296.0);
+}
+
+static int AddFloor(WorldBatch* batch)
+{
+	return batch->AddBody(glm::vec3(0.f, -10.f, 0.f), glm::vec3(100.f, 1.f, 100.f), 1, false, true);
+}
+
+WorldBatch* WorldBatch::CreateGravityScene(const WorldVariant* variants, int& cube)
+{
+	WorldBatch* batch = new WorldBatch(variants);
+	AddFloor(batch);
+	cube = batch->AddBody(glm::vec3(40.f, 50.f, -70.f), glm::vec3(2.f, 2.f, 2.f), 1, true, false);
+	batch->AddKick(cube, -7.f, glm::vec3(0.f, 2.f, 0.f));
+	return batch;
+}
+
+WorldBatch* WorldBatch::CreateMomentumScene(const WorldVariant* variants, int& firstCube)
+{
+	WorldBatch* batch = new WorldBatch(variants);
+	AddFloor(batch);
+	batch->AddBody(glm::vec3(0.f, -7.f, -50.f), glm::vec3(20.f, 2.f, 2.f), 1, false, false);
+	batch->AddBody(glm::vec3(0.f, -7.f, -90.f), glm::vec3(20.f, 2.f, 2.f), 1, false, false);
+	batch->AddBody(glm::vec3(-20.f, -7.f, -70.f), glm::vec3(2.f, 2.f, 20.f), 1, false, false);
+	batch->AddBody(glm::vec3(20.f, -7.f, -70.f), glm::vec3(2.f, 2.f, 20.f), 1, false, false);
+
+	const int cubeCount = 35;
+	firstCube = batch->GetBodyCount();
+	for (int i = 0; i < cubeCount; i++)
+	{
+		batch->AddBody(glm::vec3((0.7f * i) + 1.f - 18.f, -6.f, 0.f), glm::vec3(0.5f, 0.5f, 0.5f), 1, true, false);
+	}
+
+	//each lane draws its own cubes, in the same order ExampleScene does
+	for (int lane = 0; lane < WorldBatchLanes; lane++)
+	{
+		std::mt19937 random(variants[lane].seed);
+		for (int i = 0; i < cubeCount; i++)
+		{
+			float randomZ = RandomRange(random, -85.f, -55.f);
+			batch->SetPosition(firstCube + i, lane, glm::vec3((0.7f * i) + 1.f - 18.f, -6.f, randomZ));
+
+			float dirX = RandomRange(random, -0.5f, 0.5f);
+			RandomRange(random, -0.5f, 0.5f);   //ExampleScene draws a z direction too, but doesn't use it
+			batch->ApplyForce(firstCube + i, lane, glm::vec3(dirX, 0.f, 0.f) * variants[lane].forceScale);
+		}
+	}
+	return batch;
+}
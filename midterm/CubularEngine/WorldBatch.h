@@ -0,0 +1,153 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+/// <summary>
+/// How many worlds a WorldBatch steps at once, one per lane of an AVX register
+/// </summary>
+const int WorldBatchLanes = 8;
+
+/// <summary>
+/// What one lane's world does differently from the others in its batch
+/// </summary>
+struct WorldVariant
+{
+	unsigned int seed;      //for the random forces, the same seed gives the same cubes as ExampleScene
+	float forceScale;       //multiplies the random forces
+	float gravity;          //taken off the vertical velocity every BaseTimeStep
+	float restitution;      //how bouncy the moving bodies are (the floor never bounces)
+
+	WorldVariant() : seed(0), forceScale(1.f), gravity(.0098f), restitution(1.f) {}
+};
+
+/// <summary>
+/// Steps 8 copies of a small scene at once, for sweeping parameters over thousands of variants.
+/// Every copy has the same bodies (same sizes and weights, the same ones static), only where they are,
+/// how fast they go and the variant's parameters differ, so each value is stored as 8 floats side by side
+/// and every instruction works on all 8 worlds. Runs with AVX when the CPU has it, otherwise one lane at a time,
+/// and both give exactly the same numbers.
+/// Uses the same gravity, contacts and solver as PhysicsWorld, but leaves out what only pays off in big
+/// scenes (broadphase, islands, sleeping, contact caching and sweeping fast bodies), so the results are
+/// close to a World with the same seed rather than identical. Every moving body is checked against every
+/// other body, so keep scenes to a few dozen bodies
+/// </summary>
+class WorldBatch
+{
+private:
+	//one value for each of the 8 worlds, aligned so a load never splits a cache line
+	//(the AVX code still uses unaligned loads, vectors only promise 16 bytes before C++17's aligned new)
+	struct alignas(32) Lanes
+	{
+		float value[WorldBatchLanes];
+	};
+
+	//a pair of bodies that touch in at least one of the worlds, lanes where they don't have no mass so they do nothing
+	struct LaneContact
+	{
+		int a;                  //always moving
+		int b;
+		bool bStatic;
+		Lanes normalX, normalY, normalZ;
+		Lanes penetration;
+		Lanes normalMass;
+		Lanes velocityBias;
+		Lanes impulse;
+	};
+
+	//the gravity example's bounce: once the body gets down to height it's put back there and kicked up
+	struct Kick
+	{
+		int body;
+		float height;
+		glm::vec3 force;
+	};
+
+	//same for every world
+	std::vector<glm::vec3> colliders;
+	std::vector<float> inverseMasses;       //0 for static bodies
+	std::vector<unsigned char> floors;      //bodies that soak up bounces
+	std::vector<Kick> kicks;
+
+	//per body, per world
+	std::vector<Lanes> positionX, positionY, positionZ;
+	std::vector<Lanes> velocityX, velocityY, velocityZ;
+
+	//per world
+	WorldVariant variants[WorldBatchLanes];
+	Lanes gravity;
+	Lanes restitution;
+
+	std::vector<LaneContact> contacts;
+	int stepCount;
+	bool useAvx;
+
+	static Lanes Broadcast(float value);
+
+	//each part of the step is written twice, once a lane at a time and once with AVX, and they have to stay in sync
+	void ApplyGravityScalar(float stepScale);
+	void ApplyGravityAvx(float stepScale);
+	void FindContactsScalar();
+	void FindContactsAvx();
+	void SolveContactsScalar();
+	void SolveContactsAvx();
+	void IntegrateScalar(float stepScale);
+	void IntegrateAvx(float stepScale);
+	void ApplyKicks();
+
+public:
+	/// <summary>
+	/// Creates an empty batch
+	/// </summary>
+	/// <param name="variants">One per lane (WorldBatchLanes of them)</param>
+	WorldBatch(const WorldVariant* variants);
+
+	/// <summary>
+	/// Adds a body to every world at the same place and returns its index
+	/// </summary>
+	/// <param name="collider">Half size of the collision box</param>
+	/// <param name="weight">0 (or applyPhysics off) makes it static</param>
+	/// <param name="floor">Soaks up bounces, like a body tagged "Floor" in PhysicsWorld</param>
+	int AddBody(glm::vec3 position, glm::vec3 collider, float weight, bool applyPhysics, bool floor);
+
+	/// <summary>
+	/// Bounces the body like the gravity example does: whenever it gets down to height it's put back there and given force
+	/// </summary>
+	void AddKick(int body, float height, glm::vec3 force);
+
+	void SetPosition(int body, int lane, glm::vec3 position);
+	void ApplyForce(int body, int lane, glm::vec3 force);
+
+	/// <summary>
+	/// Steps every world, same as PhysicsWorld::Step followed by the scene's update
+	/// </summary>
+	/// <param name="timeStep">Length of the step in seconds</param>
+	void Step(float timeStep);
+
+	glm::vec3 GetPosition(int body, int lane) const;
+	glm::vec3 GetVelocity(int body, int lane) const;
+	int GetBodyCount() const { return (int)colliders.size(); }
+	int GetStepCount() const { return stepCount; }
+	const WorldVariant& GetVariant(int lane) const { return variants[lane]; }
+
+	/// <summary>
+	/// Whether the batch is running with AVX
+	/// </summary>
+	bool IsUsingAvx() const { return useAvx; }
+
+	/// <summary>
+	/// Switches between AVX and one lane at a time (for comparing them), AVX is only used if the CPU has it
+	/// </summary>
+	void SetUseAvx(bool use);
+
+	/// <summary>
+	/// The gravity example from ExampleScene: a cube dropped onto the floor and kicked back up every time it lands
+	/// </summary>
+	/// <param name="cube">Set to the index of the falling cube</param>
+	static WorldBatch* CreateGravityScene(const WorldVariant* variants, int& cube);
+
+	/// <summary>
+	/// The linear momentum example from ExampleScene: a walled arena with 35 cubes pushed by random forces from each lane's seed
+	/// </summary>
+	/// <param name="firstCube">Set to the index of the first cube, the rest follow it</param>
+	static WorldBatch* CreateMomentumScene(const WorldVariant* variants, int& firstCube);
+};
@@ -0,0 +1,45 @@
+#include "WorldHost.h"
+
+WorldHost::WorldHost(ThreadPool* threadPool)
+{
+	this->threadPool = threadPool;
+}
+
+WorldHost::~WorldHost()
+{
+	for (int i = 0; i < worlds.size(); i++)
+	{
+		delete worlds[i];
+	}
+}
+
+World* WorldHost::AddWorld(BroadphaseType broadphaseType, unsigned int seed, float forceScale)
+{
+	World* world = new World(broadphaseType, seed, forceScale, nullptr);
+	worlds.push_back(world);
+	return world;
+}
+
+void WorldHost::Step(float timeStep, int stepCount)
+{
+	std::function<void(int, int)> job = [&](int task, int thread)
+	{
+		World* world = worlds[task];
+		for (int i = 0; i < stepCount; i++)
+		{
+			world->Step(timeStep);
+		}
+	};
+
+	if (threadPool != nullptr)
+	{
+		threadPool->Run((int)worlds.size(), job);
+	}
+	else
+	{
+		for (int i = 0; i < worlds.size(); i++)
+		{
+			job(i, 0);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include "World.h"
+
+/// <summary>
+/// Runs lots of independent worlds side by side (like the same scene with different seeds and forces, for tuning).
+/// Every world is one task on the thread pool, so each one is stepped start to finish by a single thread
+/// and the worlds spread out over every core. They're stepped in lockstep: a call to Step moves every
+/// world along by the same number of steps before it returns
+/// </summary>
+class WorldHost
+{
+private:
+	ThreadPool* threadPool;
+	std::vector<World*> worlds;
+
+public:
+	/// <summary>
+	/// Creates a host with no worlds
+	/// </summary>
+	/// <param name="threadPool">Threads the worlds are stepped on (not owned)</param>
+	WorldHost(ThreadPool* threadPool);
+
+	/// <summary>
+	/// Destroys every world
+	/// </summary>
+	~WorldHost();
+
+	/// <summary>
+	/// Creates a world and adds it to the host. The world doesn't get the thread pool, it already runs on one of its threads
+	/// </summary>
+	World* AddWorld(BroadphaseType broadphaseType, unsigned int seed, float forceScale);
+
+	/// <summary>
+	/// Steps every world stepCount times, in parallel. Running several steps per call means the threads
+	/// only have to wait for each other once, instead of after every step
+	/// </summary>
+	/// <param name="timeStep">Length of each step in seconds</param>
+	void Step(float timeStep, int stepCount = 1);
+
+	int GetWorldCount() const { return (int)worlds.size(); }
+	World* GetWorld(int index) const { return worlds[index]; }
+};
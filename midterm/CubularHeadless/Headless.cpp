@@ -0,0 +1,333 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <vector>
+#include "../CubularEngine/WorldHost.h"
+#include "../CubularEngine/WorldBatch.h"
+#include "../CubularEngine/TagRegistry.h"
+#include "../CubularEngine/Replay.h"
+
+//Steps the example scene as fast as it can, with no window, GL context or sound device,
+//for running simulations on machines that can't (or don't need to) draw anything.
+//a replay runs the recording again from its seed, checks every step still comes out the same
+//and shows where the slowest recorded step spends its time (so it can be looked at under a profiler).
+//--worlds steps that many copies of the scene side by side, each with its own seed and force scale
+//--batch does the same with just the linear momentum example, 8 worlds at a time in WorldBatches
+static const char* Usage =
+	"usage: CubularHeadless [steps] [threads] [octree|sap|tree|hash|brute] [seed] [--record file]\n"
+	"       CubularHeadless --replay file [threads]\n"
+	"       CubularHeadless --worlds count [steps] [threads] [octree|sap|tree|hash|brute] [seed]\n"
+	"       CubularHeadless --batch count [steps] [threads] [seed] [--scalar]\n";
+
+static BroadphaseType ParseBroadphase(const char* name)
+{
+	if (strcmp(name, "octree") == 0)
+	{
+		return BroadphaseType::Octree;
+	}
+	if (strcmp(name, "tree") == 0)
+	{
+		return BroadphaseType::AABBTree;
+	}
+	if (strcmp(name, "hash") == 0)
+	{
+		return BroadphaseType::SpatialHash;
+	}
+	if (strcmp(name, "brute") == 0)
+	{
+		return BroadphaseType::BruteForce;
+	}
+	return BroadphaseType::SweepAndPrune;
+}
+
+static int Replay(const char* path, int threads)
+{
+	ReplayPlayer player;
+	if (!player.Load(path))
+	{
+		std::cout << "Couldn't load replay " << path << std::endl;
+		return 1;
+	}
+
+	ThreadPool* threadPool = new ThreadPool(threads);
+	World* world = new World((BroadphaseType)player.GetBroadphase(), player.GetSeed(), 1.f, threadPool);
+	PhysicsWorld* physicsWorld = world->GetPhysicsWorld();
+
+	std::cout << "Replaying " << player.GetStepCount() << " steps with seed " << player.GetSeed() << " on "
+		<< threadPool->GetThreadCount() << " threads" << std::endl;
+
+	//the slowest step when it was recorded, it's the one worth looking at
+	int slowest = 0;
+	for (int i = 1; i < player.GetStepCount(); i++)
+	{
+		if (player.GetStepMilliseconds(i) > player.GetStepMilliseconds(slowest))
+		{
+			slowest = i;
+		}
+	}
+
+	int mismatchStep = -1;
+	int mismatchBody = -1;
+	StepTimings slowestTimings = {};
+	for (int i = 0; i < player.GetStepCount(); i++)
+	{
+		//the run may have been stepping some bodies less often, do the same
+		player.Seek(i);
+		player.ApplyUpdateIntervals(physicsWorld);
+
+		world->Step(player.GetTimeStep(i));
+		if (i == slowest)
+		{
+			slowestTimings = physicsWorld->GetStepTimings();
+		}
+
+		if (mismatchStep < 0)
+		{
+			mismatchBody = player.FindMismatch(physicsWorld);
+			if (mismatchBody >= 0)
+			{
+				mismatchStep = i;
+			}
+		}
+	}
+
+	if (mismatchStep < 0)
+	{
+		std::cout << "Every step matches the recording" << std::endl;
+	}
+	else
+	{
+		std::cout << "Body " << mismatchBody << " stops matching the recording at step " << mismatchStep << std::endl;
+	}
+	std::cout << "Slowest recorded step is " << slowest << " (" << player.GetStepMilliseconds(slowest) << "ms), replayed in "
+		<< slowestTimings.broadphase << "ms broadphase, " << slowestTimings.islands << "ms islands, "
+		<< slowestTimings.narrowphase << "ms narrowphase, " << slowestTimings.response << "ms response, "
+		<< slowestTimings.integration << "ms integration" << std::endl;
+
+	delete world;
+	delete threadPool;
+	TagRegistry::Release();
+	return mismatchStep < 0 ? 0 : 2;
+}
+
+static int RunWorlds(int worldCount, int steps, int threads, BroadphaseType broadphaseType, unsigned int seed)
+{
+	const float physicsTimeStep = 1.f / 60.f;
+	const int stepsPerBatch = 60;   //how far the worlds get ahead between waiting for each other
+
+	ThreadPool* threadPool = new ThreadPool(threads);
+	WorldHost* host = new WorldHost(threadPool);
+	for (int i = 0; i < worldCount; i++)
+	{
+		//a different seed for each world, and force scales from 0.5 to 1.5
+		float forceScale = 0.5f + (worldCount > 1 ? (float)i / (worldCount - 1) : 0.5f);
+		host->AddWorld(broadphaseType, seed + i, forceScale);
+	}
+
+	std::cout << "Stepping " << worldCount << " worlds for " << steps << " steps on " << threadPool->GetThreadCount()
+		<< " threads with seeds " << seed << " to " << seed + worldCount - 1 << std::endl;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int done = 0; done < steps; done += stepsPerBatch)
+	{
+		host->Step(physicsTimeStep, std::min(stepsPerBatch, steps - done));
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	long long collisionCount = 0;
+	size_t arenaBytes = 0;
+	for (int i = 0; i < host->GetWorldCount(); i++)
+	{
+		collisionCount += host->GetWorld(i)->GetCollisionCount();
+		arenaBytes += host->GetWorld(i)->GetArena().GetBytesReserved();
+	}
+
+	std::cout << "Took " << seconds << "s, " << (double)worldCount * steps / seconds << " world steps per second" << std::endl;
+	std::cout << collisionCount << " collisions reported, " << arenaBytes / 1024 << "KB of arenas" << std::endl;
+
+	delete host;
+	delete threadPool;
+	TagRegistry::Release();
+	return 0;
+}
+
+static int RunBatches(int worldCount, int steps, int threads, unsigned int seed, bool useAvx)
+{
+	const float physicsTimeStep = 1.f / 60.f;
+	int batchCount = (worldCount + WorldBatchLanes - 1) / WorldBatchLanes;
+	worldCount = batchCount * WorldBatchLanes;
+
+	std::vector<WorldBatch*> batches;
+	int firstCube = 0;
+	for (int i = 0; i < batchCount; i++)
+	{
+		//same seeds and force scales as --worlds
+		WorldVariant variants[WorldBatchLanes];
+		for (int lane = 0; lane < WorldBatchLanes; lane++)
+		{
+			int world = i * WorldBatchLanes + lane;
+			variants[lane].seed = seed + world;
+			variants[lane].forceScale = 0.5f + (worldCount > 1 ? (float)world / (worldCount - 1) : 0.5f);
+		}
+		batches.push_back(WorldBatch::CreateMomentumScene(variants, firstCube));
+		batches.back()->SetUseAvx(useAvx);
+	}
+
+	ThreadPool* threadPool = new ThreadPool(threads);
+	std::cout << "Stepping " << worldCount << " worlds in " << batchCount << " batches for " << steps << " steps on "
+		<< threadPool->GetThreadCount() << " threads with " << (batches[0]->IsUsingAvx() ? "AVX" : "no SIMD") << std::endl;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	threadPool->Run(batchCount, [&](int task, int thread)
+	{
+		for (int i = 0; i < steps; i++)
+		{
+			batches[task]->Step(physicsTimeStep);
+		}
+	});
+	auto end = std::chrono::high_resolution_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	//which world kept its cubes moving the most, as an example of picking out a variant
+	int liveliest = 0;
+	float liveliestSpeed = -1.f;
+	for (int world = 0; world < worldCount; world++)
+	{
+		WorldBatch* batch = batches[world / WorldBatchLanes];
+		float speed = 0.f;
+		for (int body = firstCube; body < batch->GetBodyCount(); body++)
+		{
+			speed += glm::length(batch->GetVelocity(body, world % WorldBatchLanes));
+		}
+		if (speed > liveliestSpeed)
+		{
+			liveliest = world;
+			liveliestSpeed = speed;
+		}
+	}
+
+	std::cout << "Took " << seconds << "s, " << (double)worldCount * steps / seconds << " world steps per second" << std::endl;
+	std::cout << "Liveliest world is seed " << seed + liveliest << " with force scale "
+		<< batches[liveliest / WorldBatchLanes]->GetVariant(liveliest % WorldBatchLanes).forceScale << std::endl;
+
+	for (int i = 0; i < batches.size(); i++)
+	{
+		delete batches[i];
+	}
+	delete threadPool;
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0))
+	{
+		std::cout << Usage;
+		return 0;
+	}
+	//a mode without its count (or file) would otherwise be read as a step count of 0 and quietly do nothing
+	if (argc > 1 && argv[1][0] == '-' && (argc < 3 || (strcmp(argv[1], "--replay") != 0 && strcmp(argv[1], "--worlds") != 0 &&
+		strcmp(argv[1], "--batch") != 0 && strcmp(argv[1], "--record") != 0)))
+	{
+		std::cerr << Usage;
+		return 1;
+	}
+	if (argc > 2 && strcmp(argv[1], "--replay") == 0)
+	{
+		return Replay(argv[2], argc > 3 ? atoi(argv[3]) : 0);
+	}
+	if (argc > 2 && strcmp(argv[1], "--worlds") == 0)
+	{
+		int worldCount = atoi(argv[2]);
+		int steps = argc > 3 ? atoi(argv[3]) : 600;
+		if (worldCount < 1 || steps < 0)
+		{
+			std::cerr << Usage;
+			return 1;
+		}
+		return RunWorlds(worldCount, steps, argc > 4 ? atoi(argv[4]) : 0,
+			argc > 5 ? ParseBroadphase(argv[5]) : BroadphaseType::SweepAndPrune,
+			argc > 6 ? (unsigned int)strtoul(argv[6], nullptr, 10) : (unsigned int)time(NULL));
+	}
+	if (argc > 2 && strcmp(argv[1], "--batch") == 0)
+	{
+		//no worlds means no batches to step (or to report on)
+		int worldCount = atoi(argv[2]);
+		int steps = argc > 3 ? atoi(argv[3]) : 600;
+		if (worldCount < 1 || steps < 0)
+		{
+			std::cerr << Usage;
+			return 1;
+		}
+		return RunBatches(worldCount, steps, argc > 4 ? atoi(argv[4]) : 0,
+			argc > 5 ? (unsigned int)strtoul(argv[5], nullptr, 10) : (unsigned int)time(NULL),
+			!(argc > 6 && strcmp(argv[6], "--scalar") == 0));
+	}
+
+	//--record can go anywhere, everything else is read in order
+	std::vector<const char*> args;
+	const char* recordPath = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--record") != 0)
+		{
+			args.push_back(argv[i]);
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			std::cerr << Usage;
+			return 1;
+		}
+		recordPath = argv[++i];
+	}
+
+	int steps = args.size() > 0 ? atoi(args[0]) : 6000;
+	int threads = args.size() > 1 ? atoi(args[1]) : 0;    //0 uses every core
+	BroadphaseType broadphaseType = args.size() > 2 ? ParseBroadphase(args[2]) : BroadphaseType::SweepAndPrune;
+	unsigned int seed = args.size() > 3 ? (unsigned int)strtoul(args[3], nullptr, 10) : (unsigned int)time(NULL);
+
+	//same rate the windowed build runs physics at
+	const float physicsTimeStep = 1.f / 60.f;
+
+	ThreadPool* threadPool = new ThreadPool(threads);
+	World* world = new World(broadphaseType, seed, 1.f, threadPool);
+	PhysicsWorld* physicsWorld = world->GetPhysicsWorld();
+	ReplayRecorder* recorder = recordPath != nullptr ? new ReplayRecorder(recordPath, seed, (int)broadphaseType) : nullptr;
+
+	std::cout << "Stepping " << physicsWorld->GetBodyCount() << " bodies for " << steps << " steps on "
+		<< threadPool->GetThreadCount() << " threads with seed " << seed << std::endl;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < steps; i++)
+	{
+		auto stepStart = std::chrono::high_resolution_clock::now();
+		world->Step(physicsTimeStep);
+		auto stepEnd = std::chrono::high_resolution_clock::now();
+
+		if (recorder != nullptr)
+		{
+			recorder->RecordStep(physicsWorld, physicsTimeStep, std::chrono::duration<double, std::milli>(stepEnd - stepStart).count());
+		}
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	std::cout << "Took " << seconds << "s, " << steps / seconds << " steps per second ("
+		<< steps / seconds * physicsTimeStep << "x real time)" << std::endl;
+	std::cout << world->GetCollisionCount() << " collisions reported" << std::endl;
+	if (recorder != nullptr)
+	{
+		std::cout << "Recorded " << recorder->GetStepCount() << " steps to " << recordPath << " (" << recorder->GetByteCount() << " bytes)" << std::endl;
+		delete recorder;
+	}
+
+	delete world;
+	delete threadPool;
+	TagRegistry::Release();
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <cmath>
+#include "../CubularEngine/PhysicsWorld.h"
+#include "../CubularEngine/BruteForceBroadphase.h"
+#include "../CubularEngine/TagRegistry.h"
+
+//Drops cubes side by side, one stepped every step and the others only every few steps, and checks
+//the deferred ones are where the every step one is whenever they've caught up.
+//they fall fast enough by the end to be swept, so that path is checked too.
+//returns 1 if any of them drifted more than Tolerance away
+
+static const float Tolerance = 1e-3f;
+static const int StepCount = 240;
+static const int Intervals[] = { 2, 4, 7 };
+static const int IntervalCount = sizeof(Intervals) / sizeof(Intervals[0]);
+
+int main()
+{
+	const float physicsTimeStep = 1.f / 60.f;
+
+	BruteForceBroadphase broadphase;
+	PhysicsWorld* physicsWorld = new PhysicsWorld(&broadphase, nullptr);
+	TagId tag = TagRegistry::GetInstance()->Intern("Cube");
+
+	//far enough apart that they never touch
+	unsigned int reference = physicsWorld->CreateBody(glm::vec3(0.f, 0.f, 0.f), glm::vec3(.5f, .5f, .5f), 1.f, true, tag);
+	unsigned int bodies[IntervalCount];
+	for (int k = 0; k < IntervalCount; k++)
+	{
+		bodies[k] = physicsWorld->CreateBody(glm::vec3(10.f * (k + 1), 0.f, 0.f), glm::vec3(.5f, .5f, .5f), 1.f, true, tag);
+		physicsWorld->SetUpdateInterval(bodies[k], Intervals[k]);
+	}
+
+	float worstError = 0.f;
+	for (int step = 0; step < StepCount; step++)
+	{
+		physicsWorld->Step(physicsTimeStep);
+
+		for (int k = 0; k < IntervalCount; k++)
+		{
+			//same check the world uses to pick which bodies sit a step out
+			if ((step + bodies[k]) % Intervals[k] != 0)
+			{
+				continue;
+			}
+
+			float error = std::abs(physicsWorld->GetPosition(bodies[k]).y - physicsWorld->GetPosition(reference).y);
+			if (error > worstError)
+			{
+				worstError = error;
+			}
+			if (error > Tolerance)
+			{
+				std::cout << "Body stepped every " << Intervals[k] << " steps is " << error << " off at step " << step << std::endl;
+				delete physicsWorld;
+				TagRegistry::Release();
+				return 1;
+			}
+		}
+	}
+
+	std::cout << "Deferred bodies stay within " << worstError << " of the one stepped every step after "
+		<< StepCount << " steps (fell " << -physicsWorld->GetPosition(reference).y << ")" << std::endl;
+
+	delete physicsWorld;
+	TagRegistry::Release();
+	return 0;
+}
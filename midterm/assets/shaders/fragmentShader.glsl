@@ -6,13 +6,12 @@ This is the fragment shader, and it's main job is to determine the color for eac
 #version 400 core
 
 in vec4 vsps_worldPos;
+in vec4 vsps_color;     //from a uniform or from the instance, depending on the vertex shader
 
 out vec4 color;
 
-uniform vec4 colorSet;
-
 //entry point for the fragment shader
 void main(void)
 {
-    color = colorSet;
+    color = vsps_color;
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ This is the vertex shader
 in vec3 position;
 
 out vec4 vsps_worldPos;
+out vec4 vsps_color;
 
 //These are our uniform variables! They are like public static variables but
 //they are nothing like public static variables (lol). The similarity lie in
@@ -17,8 +18,15 @@ out vec4 vsps_worldPos;
 //'in' variable represents one vertex (in the vertex shader) or one pixel (in the
 //fragment shader).
 uniform mat4 modelToWorld;
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
+uniform vec4 colorSet;
+
+//the camera's matrices live in a uniform buffer shared by every program, uploaded once a frame
+//(see CameraUniforms), std140 so the layout is the same on every driver
+layout(std140) uniform CameraBlock
+{
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+};
 
 //entry point for the vertex shader
 void main(void)
@@ -28,6 +36,7 @@ void main(void)
     //move it to the world coordinates
     worldPos = modelToWorld * worldPos;
     vsps_worldPos = worldPos;
+    vsps_color = colorSet;
 
     //apply our camera matrcies to bring it to screen space
     worldPos = viewMatrix * worldPos;
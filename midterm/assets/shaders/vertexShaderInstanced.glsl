@@ -0,0 +1,32 @@
+/*
+This is the instanced version of the vertex shader, one draw call renders every copy of a mesh.
+Instead of uniforms, each copy's world matrix and color come in as vertex attributes that only
+move on once per instance (the locations are fixed so every mesh's VAO can be set up the same way)
+*/
+
+//specifies the version of the shader (and what features are enabled)
+#version 400 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in mat4 instanceWorld;    //takes up locations 1 to 4, a column each
+layout(location = 5) in vec4 instanceColor;
+
+out vec4 vsps_worldPos;
+out vec4 vsps_color;
+
+//shared with the other programs, see vertexShader.glsl
+layout(std140) uniform CameraBlock
+{
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+};
+
+//entry point for the vertex shader
+void main(void)
+{
+    vec4 worldPos = instanceWorld * vec4(position, 1.0);
+    vsps_worldPos = worldPos;
+    vsps_color = instanceColor;
+
+    gl_Position = projectionMatrix * (viewMatrix * worldPos);
+}
\ No newline at end of file